@@ -1,7 +1,12 @@
 #pragma once
 #include "room_control.h"
 #include "stm32l4xx_hal.h"
+#include "record_queue.h"
 
-void command_parser_process_esp01(uint8_t rx_byte);
-void command_parser_process_debug(uint8_t rx_byte);
+// Líneas recibidas que esperan al lazo principal (potencia de 2)
+#define COMMAND_QUEUE_LEN 4
+
+void command_parser_on_line(UART_HandleTypeDef *huart, const char *line);
+void command_parser_run(void);
+void command_parser_get_queue_stats(record_queue_stats_t *stats);
 void command_parser_process(room_control_t *room, const char *cmd, UART_HandleTypeDef *huart);
\ No newline at end of file
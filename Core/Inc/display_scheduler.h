@@ -0,0 +1,23 @@
+#ifndef DISPLAY_SCHEDULER_H
+#define DISPLAY_SCHEDULER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Tasa máxima de refresco del OLED y demora máxima para la respuesta a una tecla
+#define DISPLAY_MAX_FPS         20
+#define DISPLAY_KEY_LATENCY_MS  30
+
+typedef struct {
+    uint32_t requested;   // Solicitudes de refresco recibidas
+    uint32_t coalesced;   // Solicitudes absorbidas por un refresco ya pendiente
+    uint32_t performed;   // Refrescos enviados al panel
+} display_scheduler_stats_t;
+
+void display_scheduler_init(uint32_t max_fps, uint32_t max_latency_ms);
+void display_request_refresh(bool urgent);
+void display_scheduler_run(void);
+void display_scheduler_get_stats(display_scheduler_stats_t *stats);
+void display_scheduler_reset_stats(void);
+
+#endif
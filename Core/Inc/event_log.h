@@ -0,0 +1,20 @@
+#ifndef EVENT_LOG_H
+#define EVENT_LOG_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Líneas guardadas en RAM y caracteres por línea (128 px / 6 px de Font_6x8)
+#define EVENT_LOG_LINES        16
+#define EVENT_LOG_LINE_CHARS   21
+
+void event_log_add(const char *text);
+uint8_t event_log_count(void);
+const char *event_log_line(uint8_t age);
+
+void event_log_show(void);
+void event_log_hide(void);
+bool event_log_is_visible(void);
+void event_log_update(void);
+
+#endif
@@ -0,0 +1,26 @@
+#ifndef KEY_LATENCY_H
+#define KEY_LATENCY_H
+
+#include <stdint.h>
+#include "keypad.h"
+
+// Una muestra que no llega a la pantalla en este tiempo se descarta
+#define KEY_LATENCY_TIMEOUT_MS  1000
+
+// Etapas del camino tecla -> pantalla, en ms de HAL_GetTick()
+typedef enum {
+    KEY_LATENCY_DEBOUNCE,   // Flanco en la EXTI -> evento confirmado por el barrido
+    KEY_LATENCY_QUEUE,      // Evento en la cola -> room_control_process_key()
+    KEY_LATENCY_DISPLAY,    // Tecla procesada -> fin del envío al OLED que la muestra
+    KEY_LATENCY_TOTAL,
+    KEY_LATENCY_STAGES
+} key_latency_stage_t;
+
+void key_latency_key(const keypad_event_t *event);
+void key_latency_processed(void);
+void key_latency_before_draw(void);
+void key_latency_poll(void);
+void key_latency_report(void (*print)(const char *line));
+void key_latency_reset(void);
+
+#endif
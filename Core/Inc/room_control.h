@@ -52,6 +52,7 @@ typedef struct {
 void room_control_init(room_control_t *room);
 void room_control_update(room_control_t *room);
 void room_control_process_key(room_control_t *room, char key);
+void room_control_process_long_press(room_control_t *room, char key);
 void room_control_set_temperature(room_control_t *room, float temperature);
 void room_control_force_fan_level(room_control_t *room, fan_level_t level);
 bool room_control_change_password(room_control_t *room, const char *new_password);
@@ -0,0 +1,13 @@
+#ifndef ROOM_SCREENS_H
+#define ROOM_SCREENS_H
+
+#include "ssd1306.h"
+
+// Generated by Drivers/ssd1306/tools/screen_pack.py, do not edit.
+// Complete frames for ssd1306_LoadScreen().
+extern const uint8_t room_screen_locked[SSD1306_BUFFER_SIZE];
+extern const uint8_t room_screen_password[SSD1306_BUFFER_SIZE];
+extern const uint8_t room_screen_unlocked[SSD1306_BUFFER_SIZE];
+extern const uint8_t room_screen_denied[SSD1306_BUFFER_SIZE];
+
+#endif
@@ -0,0 +1,37 @@
+#ifndef UART_RX_H
+#define UART_RX_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "stm32l4xx_hal.h"
+
+#define UART_RX_PORTS       2
+// Buffer circular del DMA de cada puerto: la mitad es lo que puede llegar entre
+// dos interrupciones (medio y fin de transferencia) sin perder bytes
+#define UART_RX_DMA_SIZE    64
+// Línea más larga que se entrega, con el '\0'; el resto de la línea se descarta
+#define UART_RX_LINE_SIZE   32
+
+// Recibe cada línea completa, sin el fin de línea. Se llama desde la
+// interrupción: debe limitarse a guardarla para el lazo principal.
+typedef void (*uart_rx_line_handler_t)(UART_HandleTypeDef *huart, const char *line);
+
+typedef struct {
+    uint32_t bytes;
+    uint32_t lines;         // Líneas entregadas
+    uint32_t long_lines;    // Entregadas recortadas a UART_RX_LINE_SIZE - 1
+    uint32_t dropped_lines; // Descartadas por un error en medio de la línea
+    uint32_t overrun;
+    uint32_t framing;
+    uint32_t noise;
+    uint32_t parity;
+    uint32_t restarts;      // Recepción relanzada tras un error
+    uint32_t isr_max_cycles; // Peor uart_rx_event()/uart_rx_error(), en ciclos de CPU
+} uart_rx_stats_t;
+
+bool uart_rx_start(UART_HandleTypeDef *huart, uart_rx_line_handler_t on_line);
+void uart_rx_event(UART_HandleTypeDef *huart, uint16_t pos);
+void uart_rx_error(UART_HandleTypeDef *huart);
+bool uart_rx_get_stats(UART_HandleTypeDef *huart, uart_rx_stats_t *stats);
+
+#endif
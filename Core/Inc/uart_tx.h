@@ -0,0 +1,42 @@
+#ifndef UART_TX_H
+#define UART_TX_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "stm32l4xx_hal.h"
+
+#define UART_TX_PORTS           2
+// Cola de salida de cada puerto: el reporte más largo (GET_UART) debe caber entero
+#define UART_TX_BUFFER_SIZE     512
+// Espera máxima de UART_TX_WAIT por espacio en la cola
+#define UART_TX_WAIT_MS         100
+// Ventana sobre la que se calcula el caudal
+#define UART_TX_RATE_WINDOW_MS  1000
+
+// Qué hace uart_send() cuando el mensaje no cabe en la cola
+typedef enum {
+    UART_TX_DROP_NEW,   // Descarta el mensaje completo, nunca espera
+    UART_TX_WAIT        // Espera a que el DMA libere espacio, hasta UART_TX_WAIT_MS;
+                        // desde una interrupción se comporta como UART_TX_DROP_NEW
+} uart_tx_policy_t;
+
+typedef struct {
+    uint32_t queued;        // Bytes aceptados por uart_send()
+    uint32_t sent;          // Bytes que terminó de enviar el DMA
+    uint32_t dropped;       // Bytes descartados por cola llena
+    uint32_t dropped_msgs;  // Llamadas a uart_send() que perdieron algo
+    uint32_t transfers;     // Transferencias de DMA encadenadas
+    uint32_t errors;
+    uint32_t rate;          // Bytes/s de la última ventana de UART_TX_RATE_WINDOW_MS
+    uint32_t max_rate;
+    uint16_t backlog;       // Bytes por enviar, incluida la transferencia en curso
+    uint16_t max_backlog;
+} uart_tx_stats_t;
+
+bool uart_tx_init(UART_HandleTypeDef *huart, uart_tx_policy_t policy);
+bool uart_send(UART_HandleTypeDef *huart, const void *data, uint16_t len);
+void uart_tx_complete(UART_HandleTypeDef *huart);
+void uart_tx_error(UART_HandleTypeDef *huart);
+bool uart_tx_get_stats(UART_HandleTypeDef *huart, uart_tx_stats_t *stats);
+
+#endif
@@ -1,6 +1,11 @@
 #include "command_parser.h"
 #include "room_control.h"
 #include "temperature_sensor.h"
+#include "display_scheduler.h"
+#include "keypad.h"
+#include "key_latency.h"
+#include "uart_rx.h"
+#include "uart_tx.h"
 #include "main.h"
 #include <string.h>
 #include <stdio.h>
@@ -10,42 +15,56 @@ extern UART_HandleTypeDef huart2;
 extern UART_HandleTypeDef huart3;
 extern room_control_t room_system;
 
-#define CMD_BUFFER_SIZE 32
+#define CMD_BUFFER_SIZE UART_RX_LINE_SIZE  // Las líneas llegan ya recortadas por uart_rx
 
-static char esp01_cmd_buffer[CMD_BUFFER_SIZE];
-static uint8_t esp01_cmd_index = 0;
-static char debug_cmd_buffer[CMD_BUFFER_SIZE];
-static uint8_t debug_cmd_index = 0;
+// Línea completa esperando al lazo principal, con la UART de la respuesta
+typedef struct {
+    UART_HandleTypeDef *huart;
+    char cmd[CMD_BUFFER_SIZE];
+} command_line_t;
+
+// La llenan las interrupciones de las dos UART (misma prioridad, no se anidan)
+// y la vacía command_parser_run(). Llena, se descarta la línea nueva.
+RECORD_QUEUE_DEFINE(command_queue, command_line_t, COMMAND_QUEUE_LEN, RECORD_QUEUE_REJECT_NEW)
+static command_queue_t pending;
+
+// UART de la respuesta en curso, para los reportes de varias líneas
+static UART_HandleTypeDef *report_uart;
+
+static void report_print(const char *line) {
+    uart_send(report_uart, line, strlen(line));
+}
 
 /**
- * @brief Procesa cada byte recibido por ESP-01 (USART3)
- * @param rx_byte Byte recibido
+ * @brief Recibe las líneas completas de ESP-01 (USART3) y de debug (USART2)
+ *        armadas por uart_rx. Corre en la interrupción: solo encola, el
+ *        comando se ejecuta en command_parser_run()
  */
-void command_parser_process_esp01(uint8_t rx_byte) {
-    if (rx_byte == '\n' || rx_byte == '\r') {
-        esp01_cmd_buffer[esp01_cmd_index] = '\0';
-        command_parser_process(&room_system, esp01_cmd_buffer, &huart3);
-        esp01_cmd_index = 0;
-    } else if (esp01_cmd_index < CMD_BUFFER_SIZE - 1) {
-        esp01_cmd_buffer[esp01_cmd_index++] = rx_byte;
-    }
+void command_parser_on_line(UART_HandleTypeDef *huart, const char *line) {
+    command_line_t entry = {.huart = huart};
+    strncpy(entry.cmd, line, CMD_BUFFER_SIZE - 1);
+    entry.cmd[CMD_BUFFER_SIZE - 1] = '\0';
+    command_queue_push(&pending, &entry);
 }
 
 /**
- * @brief Procesa cada byte recibido por debug (USART2)
- * @param rx_byte Byte recibido
+ * @brief Ejecuta los comandos encolados, llamar desde el lazo principal.
+ *        La respuesta sale por la UART de la que llegó cada uno.
  */
-void command_parser_process_debug(uint8_t rx_byte) {
-    
-    if (rx_byte == '\n' || rx_byte == '\r') {
-        debug_cmd_buffer[debug_cmd_index] = '\0';
-        command_parser_process(&room_system, debug_cmd_buffer, &huart2);
-        debug_cmd_index = 0;
-    } else if (debug_cmd_index < CMD_BUFFER_SIZE - 1) {
-        debug_cmd_buffer[debug_cmd_index++] = rx_byte;
+void command_parser_run(void) {
+    command_line_t entry;
+    while (command_queue_pop(&pending, &entry)) {
+        command_parser_process(&room_system, entry.cmd, entry.huart);
     }
 }
 
+/**
+ * @brief Copia los contadores de la cola de comandos
+ */
+void command_parser_get_queue_stats(record_queue_stats_t *stats) {
+    command_queue_get_stats(&pending, stats);
+}
+
 /**
  * @brief Procesa un comando recibido y ejecuta la acción correspondiente
  * @param room Puntero a la estructura de control de la habitación
@@ -72,7 +91,7 @@ void command_parser_process(room_control_t *room, const char *cmd, UART_HandleTy
     // Solo permite comandos si el sistema está desbloqueado
     if (room_control_get_state(room) != ROOM_STATE_UNLOCKED) {
         snprintf(tx_buffer, sizeof(tx_buffer), "SISTEMA BLOQUEADO\r\n"); // Mensaje de sistema bloqueado
-        HAL_UART_Transmit(huart, (uint8_t*)tx_buffer, strlen(tx_buffer), 1000); 
+        uart_send(huart, tx_buffer, strlen(tx_buffer)); 
         return; 
     }
 
@@ -80,14 +99,14 @@ void command_parser_process(room_control_t *room, const char *cmd, UART_HandleTy
     if (strcmp(clean_cmd, "GET_TEMP") == 0) {
         int temp = (int)(temperature_sensor_read() + 0.5f); // Lee y redondea la temperatura
         snprintf(tx_buffer, sizeof(tx_buffer), "TEMP: %d C\r\n", temp); // Prepara respuesta
-        HAL_UART_Transmit(huart, (uint8_t*)tx_buffer, strlen(tx_buffer), 1000); 
+        uart_send(huart, tx_buffer, strlen(tx_buffer)); 
 
     // Comando para obtener el estado del sistema y nivel del ventilador
     } else if (strcmp(clean_cmd, "GET_STATUS") == 0) {
         snprintf(tx_buffer, sizeof(tx_buffer), "SYSTEM: %s\r\n", room_control_get_state(room) == ROOM_STATE_LOCKED ? "LOCKED" : "UNLOCKED");
-        HAL_UART_Transmit(huart, (uint8_t*)tx_buffer, strlen(tx_buffer), 1000); // Estado del sistema
+        uart_send(huart, tx_buffer, strlen(tx_buffer)); // Estado del sistema
         snprintf(tx_buffer, sizeof(tx_buffer), "FAN: %d\r\n", room_control_get_fan_level(room));
-        HAL_UART_Transmit(huart, (uint8_t*)tx_buffer, strlen(tx_buffer), 1000); // Nivel del ventilador
+        uart_send(huart, tx_buffer, strlen(tx_buffer)); // Nivel del ventilador
 
     // Comando para cambiar la contraseña
     } else if (strncmp(clean_cmd, "SET_PASS:", 9) == 0) {
@@ -104,7 +123,7 @@ void command_parser_process(room_control_t *room, const char *cmd, UART_HandleTy
         } else {
             snprintf(tx_buffer, sizeof(tx_buffer), "INVALID PASSWORD\r\n"); // Respuesta de error
         }
-        HAL_UART_Transmit(huart, (uint8_t*)tx_buffer, strlen(tx_buffer), 1000); 
+        uart_send(huart, tx_buffer, strlen(tx_buffer)); 
 
     // Comando para forzar el nivel del ventilador
     } else if (strncmp(clean_cmd, "FORCE_FAN:", 10) == 0) {
@@ -122,11 +141,81 @@ void command_parser_process(room_control_t *room, const char *cmd, UART_HandleTy
         } else {
             snprintf(tx_buffer, sizeof(tx_buffer), "INVALID FAN LEVEL\r\n"); // Respuesta de error
         }
-        HAL_UART_Transmit(huart, (uint8_t*)tx_buffer, strlen(tx_buffer), 1000); 
+        uart_send(huart, tx_buffer, strlen(tx_buffer)); 
+
+    // Comando para consultar los contadores de refresco del OLED
+    } else if (strcmp(clean_cmd, "GET_DISPLAY") == 0) {
+        display_scheduler_stats_t stats;
+        display_scheduler_get_stats(&stats);
+        snprintf(tx_buffer, sizeof(tx_buffer), "DISPLAY: REQ %lu COAL %lu DONE %lu\r\n",
+                 (unsigned long)stats.requested, (unsigned long)stats.coalesced, (unsigned long)stats.performed);
+        uart_send(huart, tx_buffer, strlen(tx_buffer));
+
+    // Comando para consultar la cola de eventos del teclado
+    } else if (strcmp(clean_cmd, "GET_KEYPAD") == 0) {
+        keypad_queue_stats_t stats;
+        keypad_get_queue_stats(&stats);
+        snprintf(tx_buffer, sizeof(tx_buffer), "KEYPAD: EVT %lu DROP %lu MAX %lu/%u\r\n",
+                 (unsigned long)stats.pushed, (unsigned long)stats.dropped,
+                 (unsigned long)stats.high_watermark, KEYPAD_EVENT_QUEUE_LEN);
+        uart_send(huart, tx_buffer, strlen(tx_buffer));
+
+    // Comando para consultar el histograma de latencia de tecla a pantalla
+    } else if (strcmp(clean_cmd, "GET_LATENCY") == 0) {
+        report_uart = huart;
+        key_latency_report(report_print);
+
+    // Comando para reiniciar las medidas de latencia
+    } else if (strcmp(clean_cmd, "RESET_LATENCY") == 0) {
+        key_latency_reset();
+        snprintf(tx_buffer, sizeof(tx_buffer), "LATENCY RESET\r\n");
+        uart_send(huart, tx_buffer, strlen(tx_buffer));
+
+    // Comando para consultar la recepción y la transmisión por DMA de las dos UART y la cola de comandos
+    } else if (strcmp(clean_cmd, "GET_UART") == 0) {
+        UART_HandleTypeDef *uarts[] = {&huart2, &huart3};
+        for (uint8_t i = 0; i < 2; i++) {
+            uart_rx_stats_t stats;
+            if (!uart_rx_get_stats(uarts[i], &stats)) {
+                continue;
+            }
+            snprintf(tx_buffer, sizeof(tx_buffer), "USART%u: RX %lu LINES %lu LONG %lu DROP %lu\r\n", i ? 3 : 2,
+                     (unsigned long)stats.bytes, (unsigned long)stats.lines,
+                     (unsigned long)stats.long_lines, (unsigned long)stats.dropped_lines);
+            uart_send(huart, tx_buffer, strlen(tx_buffer));
+            snprintf(tx_buffer, sizeof(tx_buffer), "USART%u: ORE %lu FE %lu NE %lu PE %lu RESTART %lu\r\n", i ? 3 : 2,
+                     (unsigned long)stats.overrun, (unsigned long)stats.framing, (unsigned long)stats.noise,
+                     (unsigned long)stats.parity, (unsigned long)stats.restarts);
+            uart_send(huart, tx_buffer, strlen(tx_buffer));
+            snprintf(tx_buffer, sizeof(tx_buffer), "USART%u: ISR MAX %lu CYC %lu US\r\n", i ? 3 : 2,
+                     (unsigned long)stats.isr_max_cycles,
+                     (unsigned long)(stats.isr_max_cycles / (SystemCoreClock / 1000000)));
+            uart_send(huart, tx_buffer, strlen(tx_buffer));
+        }
+        for (uint8_t i = 0; i < 2; i++) {
+            uart_tx_stats_t stats;
+            if (!uart_tx_get_stats(uarts[i], &stats)) {
+                continue;
+            }
+            snprintf(tx_buffer, sizeof(tx_buffer), "USART%u: TX %lu B/S %lu MAX %lu DMA %lu\r\n", i ? 3 : 2,
+                     (unsigned long)stats.sent, (unsigned long)stats.rate,
+                     (unsigned long)stats.max_rate, (unsigned long)stats.transfers);
+            uart_send(huart, tx_buffer, strlen(tx_buffer));
+            snprintf(tx_buffer, sizeof(tx_buffer), "USART%u: COLA %u MAX %u/%u DROP %lu/%lu ERR %lu\r\n", i ? 3 : 2,
+                     stats.backlog, stats.max_backlog, UART_TX_BUFFER_SIZE,
+                     (unsigned long)stats.dropped, (unsigned long)stats.dropped_msgs, (unsigned long)stats.errors);
+            uart_send(huart, tx_buffer, strlen(tx_buffer));
+        }
+        record_queue_stats_t queue;
+        command_queue_get_stats(&pending, &queue);
+        snprintf(tx_buffer, sizeof(tx_buffer), "CMD: QUEUED %lu DROP %lu MAX %lu/%u\r\n",
+                 (unsigned long)queue.pushed, (unsigned long)queue.dropped,
+                 (unsigned long)queue.high_watermark, COMMAND_QUEUE_LEN);
+        uart_send(huart, tx_buffer, strlen(tx_buffer));
 
     // Comando desconocido
     } else {
         snprintf(tx_buffer, sizeof(tx_buffer), "UNKNOWN COMMAND\r\n"); // Respuesta de comando desconocido
-        HAL_UART_Transmit(huart, (uint8_t*)tx_buffer, strlen(tx_buffer), 1000); 
+        uart_send(huart, tx_buffer, strlen(tx_buffer)); 
     }
 }
\ No newline at end of file
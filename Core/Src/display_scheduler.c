@@ -0,0 +1,80 @@
+#include "display_scheduler.h"
+#include "ssd1306.h"
+#include <string.h>
+
+// Intervalo mínimo entre refrescos y demora máxima de una solicitud urgente
+static uint32_t frame_period_ms = 1000 / DISPLAY_MAX_FPS;
+static uint32_t urgent_latency_ms = DISPLAY_KEY_LATENCY_MS;
+
+static bool refresh_pending = false;
+static bool refresh_urgent = false;
+static uint32_t urgent_since = 0;
+static uint32_t last_flush = 0;
+
+static display_scheduler_stats_t stats;
+
+/**
+ * @brief Configura el planificador de refrescos del OLED
+ * @param max_fps Refrescos por segundo como máximo (0 = sin límite)
+ * @param max_latency_ms Demora máxima de una solicitud urgente, aunque adelante el cuadro
+ */
+void display_scheduler_init(uint32_t max_fps, uint32_t max_latency_ms) {
+    frame_period_ms = max_fps ? 1000 / max_fps : 0;
+    urgent_latency_ms = max_latency_ms;
+    refresh_pending = false;
+    refresh_urgent = false;
+    last_flush = HAL_GetTick() - frame_period_ms;
+    memset(&stats, 0, sizeof(stats));
+}
+
+/**
+ * @brief Solicita enviar el framebuffer al panel. Varias solicitudes antes del
+ *        siguiente cuadro se agrupan en un solo refresco.
+ * @param urgent true para respuestas al usuario (teclado), que no esperan más
+ *        de max_latency_ms aunque no haya pasado el intervalo entre cuadros
+ */
+void display_request_refresh(bool urgent) {
+    stats.requested++;
+    if (refresh_pending) {
+        stats.coalesced++;
+    }
+    if (urgent && !refresh_urgent) {
+        refresh_urgent = true;
+        urgent_since = HAL_GetTick();
+    }
+    refresh_pending = true;
+}
+
+/**
+ * @brief Envía el refresco pendiente cuando toca. Llamar en cada vuelta del lazo principal.
+ */
+void display_scheduler_run(void) {
+    if (!refresh_pending) {
+        return;
+    }
+
+    uint32_t now = HAL_GetTick();
+    bool frame_due = (now - last_flush) >= frame_period_ms;
+    bool deadline = refresh_urgent && (now - urgent_since) >= urgent_latency_ms;
+    if (!frame_due && !deadline) {
+        return;
+    }
+
+    // Si el cuadro anterior sigue en el bus, se reintenta en la siguiente vuelta
+    if (ssd1306_UpdateScreenAsync() == SSD1306_BUSY) {
+        return;
+    }
+
+    stats.performed++;
+    last_flush = now;
+    refresh_pending = false;
+    refresh_urgent = false;
+}
+
+void display_scheduler_get_stats(display_scheduler_stats_t *out) {
+    *out = stats;
+}
+
+void display_scheduler_reset_stats(void) {
+    memset(&stats, 0, sizeof(stats));
+}
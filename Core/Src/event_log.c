@@ -0,0 +1,152 @@
+#include "event_log.h"
+#include "ssd1306.h"
+#include "ssd1306_fonts.h"
+#include "stm32l4xx_hal.h"
+#include <stdio.h>
+#include <string.h>
+
+// El desplazamiento usa la línea de inicio del controlador, que recorre las
+// 64 filas de su RAM: el panel debe mostrarlas todas
+#if (SSD1306_HEIGHT != 64)
+#error "event_log necesita un panel de 64 líneas"
+#endif
+
+// Cada línea del registro ocupa exactamente una página de 8 px
+#define EVENT_LOG_ROWS  SSD1306_PAGES
+
+// Anillo de líneas en RAM: la más reciente queda en head - 1
+static char lines[EVENT_LOG_LINES][EVENT_LOG_LINE_CHARS + 1];
+static uint8_t head = 0;
+static uint8_t count = 0;
+
+// Líneas agregadas que todavía no están en pantalla
+static uint8_t unshown = 0;
+
+// Estado de la vista: página de la RAM que está arriba del panel y filas ocupadas
+static bool visible = false;
+static bool redraw = false;
+static uint8_t top_page = 0;
+static uint8_t rows_used = 0;
+
+/**
+ * @brief Agrega una línea al registro, con el tiempo desde el arranque (mm:ss).
+ *        Solo copia el texto; se dibuja en la siguiente event_log_update().
+ * @param text Texto del evento, se corta a lo que cabe en una línea
+ */
+void event_log_add(const char *text) {
+    uint32_t seconds = HAL_GetTick() / 1000;
+    char line[EVENT_LOG_LINE_CHARS + 1];
+    snprintf(line, sizeof(line), "%02lu:%02lu %s",
+             (unsigned long)((seconds / 60) % 100), (unsigned long)(seconds % 60), text);
+
+    // Solo desde el lazo principal: room_control y los comandos, que ahora se
+    // ejecutan en command_parser_run(). Ninguna interrupción lo llama.
+    memcpy(lines[head], line, sizeof(line));
+    head = (head + 1) % EVENT_LOG_LINES;
+    if (count < EVENT_LOG_LINES) {
+        count++;
+    }
+    if (unshown < EVENT_LOG_LINES) {
+        unshown++;
+    }
+}
+
+uint8_t event_log_count(void) {
+    return count;
+}
+
+/**
+ * @brief Devuelve una línea guardada
+ * @param age 0 para la más reciente, hasta event_log_count() - 1
+ * @return La línea, o NULL si no existe
+ */
+const char *event_log_line(uint8_t age) {
+    if (age >= count) {
+        return NULL;
+    }
+    return lines[(head + EVENT_LOG_LINES - 1 - age) % EVENT_LOG_LINES];
+}
+
+/**
+ * @brief Muestra el registro en el OLED a partir de la siguiente event_log_update()
+ */
+void event_log_show(void) {
+    visible = true;
+    redraw = true;
+}
+
+/**
+ * @brief Quita el registro: vuelve la línea de inicio a 0. El framebuffer queda
+ *        con las líneas del registro, quien retoma la pantalla debe redibujarla.
+ */
+void event_log_hide(void) {
+    if (!visible) {
+        return;
+    }
+    visible = false;
+    top_page = 0;
+    ssd1306_SetStartLine(0);
+}
+
+bool event_log_is_visible(void) {
+    return visible;
+}
+
+// Escribe una línea en una página del framebuffer, borrando lo que había
+static void event_log_draw_line(uint8_t page, const char *text) {
+    ssd1306_FillRectangle(0, page * 8, SSD1306_WIDTH - 1, page * 8 + 7, Black);
+    ssd1306_SetCursor(0, page * 8);
+    ssd1306_WriteString((char *)text, Font_6x8, White);
+}
+
+/**
+ * @brief Lleva al OLED las líneas nuevas mientras la vista está activa.
+ *        Cada línea escribe una sola página y, con la pantalla llena, mueve la
+ *        línea de inicio una página en vez de reenviar el cuadro completo.
+ */
+void event_log_update(void) {
+    if (!visible) {
+        return;
+    }
+
+    uint8_t pending = unshown;
+    unshown = 0;
+
+    if (pending >= EVENT_LOG_ROWS) {
+        // Más líneas nuevas que filas: igual se redibuja todo
+        redraw = true;
+    }
+
+    if (redraw) {
+        // Las últimas líneas, la más antigua arriba, desde la página 0
+        redraw = false;
+        ssd1306_Fill(Black);
+        rows_used = (count < EVENT_LOG_ROWS) ? count : EVENT_LOG_ROWS;
+        for (uint8_t row = 0; row < rows_used; row++) {
+            event_log_draw_line(row, event_log_line(rows_used - 1 - row));
+        }
+        top_page = 0;
+        ssd1306_WriteCommand(0x2E); // Detiene un desplazamiento continuo que hubiera quedado activo
+        ssd1306_SetStartLine(0);
+        ssd1306_UpdateScreen();
+        return;
+    }
+
+    for (uint8_t i = pending; i > 0; i--) {
+        const char *text = event_log_line(i - 1);
+
+        if (rows_used < EVENT_LOG_ROWS) {
+            // Todavía hay filas libres debajo de la última línea
+            uint8_t page = (top_page + rows_used) % EVENT_LOG_ROWS;
+            event_log_draw_line(page, text);
+            ssd1306_UpdateRegion(0, page * 8, SSD1306_WIDTH, 8);
+            rows_used++;
+        } else {
+            // La página de arriba (la línea más vieja) pasa a ser la última
+            event_log_draw_line(top_page, text);
+            ssd1306_UpdateRegion(0, top_page * 8, SSD1306_WIDTH, 8);
+            top_page = (top_page + 1) % EVENT_LOG_ROWS;
+            ssd1306_SetStartLine(top_page * 8);
+        }
+    }
+}
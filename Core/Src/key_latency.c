@@ -0,0 +1,147 @@
+#include "key_latency.h"
+#include "ssd1306.h"
+#include "stm32l4xx_hal.h"
+#include <stdio.h>
+#include <string.h>
+
+// Límite superior (exclusivo) de cada barra del histograma del total; la última no tiene
+static const uint16_t hist_limits_ms[] = {10, 20, 30, 50, 75, 100, 150, 250};
+#define HIST_BINS (sizeof(hist_limits_ms) / sizeof(hist_limits_ms[0]) + 1)
+
+static const char *const stage_names[KEY_LATENCY_STAGES] = {
+    "flanco-barrido", "barrido-proceso", "proceso-pantalla", "total"
+};
+
+// Se sigue una tecla a la vez: las que llegan mientras tanto no se miden
+typedef enum {
+    SAMPLE_IDLE,
+    SAMPLE_QUEUED,      // Sacada de la cola, por procesar
+    SAMPLE_PROCESSED,   // Procesada, falta dibujarla
+    SAMPLE_DRAWING      // Dibujada, se espera el envío al panel
+} sample_state_t;
+
+static sample_state_t state = SAMPLE_IDLE;
+static uint32_t t_edge, t_scan, t_process;
+static uint32_t flushes_before_draw;
+
+static uint32_t samples = 0;
+static uint32_t timeouts = 0;
+static uint32_t sum_ms[KEY_LATENCY_STAGES];
+static uint32_t max_ms[KEY_LATENCY_STAGES];
+static uint32_t histogram[HIST_BINS];
+
+static uint32_t flush_count(void) {
+    SSD1306_FlushStats_t stats;
+    ssd1306_GetFlushStats(&stats);
+    return stats.Flushes;
+}
+
+static void add_stage(key_latency_stage_t stage, uint32_t ms) {
+    sum_ms[stage] += ms;
+    if (ms > max_ms[stage]) {
+        max_ms[stage] = ms;
+    }
+}
+
+/**
+ * @brief Empieza una muestra con una pulsación recién sacada de la cola del teclado
+ */
+void key_latency_key(const keypad_event_t *event) {
+    if (state != SAMPLE_IDLE || event->type != KEYPAD_EVENT_PRESS) {
+        return;
+    }
+    t_edge = event->edge_time;
+    t_scan = event->time;
+    state = SAMPLE_QUEUED;
+}
+
+/**
+ * @brief Llamar al volver de room_control_process_key()
+ */
+void key_latency_processed(void) {
+    if (state == SAMPLE_QUEUED) {
+        t_process = HAL_GetTick();
+        state = SAMPLE_PROCESSED;
+    }
+}
+
+/**
+ * @brief Llamar justo antes de room_control_update(), que dibuja la tecla:
+ *        cuenta el primer envío al OLED que empiece a partir de aquí
+ */
+void key_latency_before_draw(void) {
+    if (state == SAMPLE_PROCESSED) {
+        flushes_before_draw = flush_count();
+        state = SAMPLE_DRAWING;
+    }
+}
+
+/**
+ * @brief Llamar después de display_scheduler_run(): cierra la muestra cuando el
+ *        envío que la contiene terminó (también los asíncronos)
+ */
+void key_latency_poll(void) {
+    if (state == SAMPLE_IDLE || state == SAMPLE_QUEUED) {
+        return;
+    }
+
+    uint32_t now = HAL_GetTick();
+    if (now - t_edge > KEY_LATENCY_TIMEOUT_MS) {
+        timeouts++;
+        state = SAMPLE_IDLE;
+        return;
+    }
+    if (state != SAMPLE_DRAWING || flush_count() == flushes_before_draw || ssd1306_IsFlushBusy()) {
+        return;
+    }
+
+    uint32_t total = now - t_edge;
+    add_stage(KEY_LATENCY_DEBOUNCE, t_scan - t_edge);
+    add_stage(KEY_LATENCY_QUEUE, t_process - t_scan);
+    add_stage(KEY_LATENCY_DISPLAY, now - t_process);
+    add_stage(KEY_LATENCY_TOTAL, total);
+
+    uint8_t bin = 0;
+    while (bin < HIST_BINS - 1 && total >= hist_limits_ms[bin]) {
+        bin++;
+    }
+    histogram[bin]++;
+    samples++;
+    state = SAMPLE_IDLE;
+}
+
+/**
+ * @brief Escribe las medidas como CSV, una línea por llamada a print
+ */
+void key_latency_report(void (*print)(const char *line)) {
+    char line[48];
+
+    snprintf(line, sizeof(line), "LATENCIA: N %lu SIN_REFRESCO %lu\r\n",
+             (unsigned long)samples, (unsigned long)timeouts);
+    print(line);
+    print("etapa,prom_ms,max_ms\r\n");
+    for (uint8_t stage = 0; stage < KEY_LATENCY_STAGES; stage++) {
+        snprintf(line, sizeof(line), "%s,%lu,%lu\r\n", stage_names[stage],
+                 (unsigned long)(samples ? sum_ms[stage] / samples : 0), (unsigned long)max_ms[stage]);
+        print(line);
+    }
+    print("total_ms,teclas\r\n");
+    for (uint8_t bin = 0; bin < HIST_BINS; bin++) {
+        if (bin < HIST_BINS - 1) {
+            snprintf(line, sizeof(line), "%u-%u,%lu\r\n", bin ? hist_limits_ms[bin - 1] : 0,
+                     hist_limits_ms[bin] - 1, (unsigned long)histogram[bin]);
+        } else {
+            snprintf(line, sizeof(line), "%u+,%lu\r\n", hist_limits_ms[bin - 1], (unsigned long)histogram[bin]);
+        }
+        print(line);
+    }
+}
+
+void key_latency_reset(void) {
+    state = SAMPLE_IDLE;
+    samples = 0;
+    timeouts = 0;
+    memset(sum_ms, 0, sizeof(sum_ms));
+    memset(max_ms, 0, sizeof(max_ms));
+    memset(histogram, 0, sizeof(histogram));
+}
@@ -24,7 +24,7 @@
 /* USER CODE BEGIN Includes */
 #include "led.h"
 #include "keypad.h"
-#include "ring_buffer.h"
+#include "key_latency.h"
 #include "room_control.h"
 #include <stdio.h>
 #include <string.h>
@@ -33,6 +33,10 @@
 #include "ssd1306_fonts.h"
 #include "temperature_sensor.h"
 #include "command_parser.h"
+#include "uart_rx.h"
+#include "uart_tx.h"
+#include "display_scheduler.h"
+#include "ssd1306_tests.h"
 
 /* USER CODE END Includes */
 
@@ -43,6 +47,8 @@
 
 /* Private define ------------------------------------------------------------*/
 /* USER CODE BEGIN PD */
+// Descomentar para medir las primitivas del OLED al arrancar; la tabla sale por USART2
+// #define DISPLAY_BENCHMARK
 
 /* USER CODE END PD */
 
@@ -55,12 +61,16 @@
 ADC_HandleTypeDef hadc1;
 
 I2C_HandleTypeDef hi2c1;
+DMA_HandleTypeDef hdma_i2c1_tx;
 
 TIM_HandleTypeDef htim3;
-DMA_HandleTypeDef hdma_tim3_ch1_trig;
 
 UART_HandleTypeDef huart2;
 UART_HandleTypeDef huart3;
+DMA_HandleTypeDef hdma_usart2_rx;
+DMA_HandleTypeDef hdma_usart2_tx;
+DMA_HandleTypeDef hdma_usart3_rx;
+DMA_HandleTypeDef hdma_usart3_tx;
 
 /* USER CODE BEGIN PV */
 uint8_t button_pressed = 0; // Flag to indicate if the button is pressed
@@ -72,9 +82,6 @@ led_handle_t led_access = {
 led_handle_t heartbeat_led = {
     .port = LD2_GPIO_Port,
     .pin = LD2_Pin};
-uint8_t usart_2_rxbyte = 0; // Variable to hold received byte from UART2
-uint8_t usart_3_rxbyte = 0; // Variable to hold received byte from UART3
-uint8_t rx_byte_esp01 = 0;  // Variable to hold received byte for ESP-01 (USART3)
 
 keypad_handle_t keypad = {
     .row_ports = {KEYPAD_R1_GPIO_Port, KEYPAD_R2_GPIO_Port, KEYPAD_R3_GPIO_Port, KEYPAD_R4_GPIO_Port},
@@ -82,12 +89,6 @@ keypad_handle_t keypad = {
     .col_ports = {KEYPAD_C1_GPIO_Port, KEYPAD_C2_GPIO_Port, KEYPAD_C3_GPIO_Port, KEYPAD_C4_GPIO_Port},
     .col_pins = {KEYPAD_C1_Pin, KEYPAD_C2_Pin, KEYPAD_C3_Pin, KEYPAD_C4_Pin}};
 
-#define KEYPAD_BUFFER_LEN 16
-uint8_t keypad_buffer[KEYPAD_BUFFER_LEN];
-ring_buffer_t keypad_rb;
-
-volatile uint16_t keypad_interrupt_pin = 0;
-
 // Room control system instance
 room_control_t room_system;
 /* USER CODE END PV */
@@ -115,21 +116,47 @@ void HAL_GPIO_EXTI_Callback(uint16_t GPIO_Pin)
   }
   else
   {
-    keypad_interrupt_pin = GPIO_Pin;
+    keypad_irq(&keypad, GPIO_Pin);
   }
 }
 
-void HAL_UART_RxCpltCallback(UART_HandleTypeDef *huart)
+// SysTick (1 ms): un paso del barrido del teclado
+void HAL_SYSTICK_Callback(void)
+{
+  keypad_tick(&keypad);
+}
+
+// USART2 y USART3 reciben por DMA circular: mitad, final o línea inactiva
+void HAL_UARTEx_RxEventCallback(UART_HandleTypeDef *huart, uint16_t Size)
+{
+  uart_rx_event(huart, Size);
+}
+
+void HAL_UART_ErrorCallback(UART_HandleTypeDef *huart)
+{
+  uart_rx_error(huart); // Cuenta el error y relanza la recepción
+  uart_tx_error(huart);
+}
+
+// Fin de una transferencia de salida: se encadena la siguiente de la cola
+void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart)
+{
+  uart_tx_complete(huart);
+}
+
+void HAL_I2C_MemTxCpltCallback(I2C_HandleTypeDef *hi2c)
 {
-  if (huart->Instance == USART3)
+  if (hi2c->Instance == I2C1)
   {
-    command_parser_process_esp01(usart_3_rxbyte);
-    HAL_UART_Receive_IT(&huart3, &usart_3_rxbyte, 1);
+    ssd1306_FlushCpltCallback(); // Siguiente tramo del refresco del OLED
   }
-  else if (huart->Instance == USART2)
+}
+
+void HAL_I2C_ErrorCallback(I2C_HandleTypeDef *hi2c)
+{
+  if (hi2c->Instance == I2C1)
   {
-    command_parser_process_debug(usart_2_rxbyte);
-    HAL_UART_Receive_IT(&huart2, &usart_2_rxbyte, 1);
+    ssd1306_FlushErrorCallback();
   }
 }
 
@@ -143,16 +170,19 @@ void heartbeat(void)
   }
 }
 
-void write_to_oled(char *message, SSD1306_COLOR color, uint8_t x, uint8_t y)
+#ifdef DISPLAY_BENCHMARK
+// Salida de ssd1306_TestBenchmark() por la consola de depuración
+static void benchmark_print(const char *line)
 {
-  ssd1306_Fill(Black);     // Clear the display
-  ssd1306_SetCursor(x, y); // Set cursor to the specified position
-  ssd1306_WriteString(message, Font_11x18, color);
-  ssd1306_UpdateScreen(); // Update the display to show the message
+  HAL_UART_Transmit(&huart2, (uint8_t *)line, strlen(line), HAL_MAX_DELAY);
 }
+#endif
+
+// Comandos que encolaron las interrupciones de USART2/USART3: se ejecutan aquí,
+// fuera de la interrupción, porque leen el ADC y responden por la UART
 void command_parser(void)
 {
-  
+  command_parser_run();
 }
 
 /* USER CODE END 0 */
@@ -195,13 +225,20 @@ int main(void)
   /* USER CODE BEGIN 2 */
 
   ssd1306_Init();
-  HAL_UART_Receive_IT(&huart3, &usart_3_rxbyte, 1);
-  HAL_UART_Receive_IT(&huart2, &usart_2_rxbyte, 1);
+#ifdef DISPLAY_BENCHMARK
+  ssd1306_TestBenchmark(benchmark_print);
+#endif
+  // Salida por DMA: el enlace lento del ESP-01 nunca frena el lazo principal,
+  // la consola de depuración espera un poco antes de perder texto
+  uart_tx_init(&huart3, UART_TX_DROP_NEW);
+  uart_tx_init(&huart2, UART_TX_WAIT);
+  uart_rx_start(&huart3, command_parser_on_line); // ESP-01
+  uart_rx_start(&huart2, command_parser_on_line); // Debug
 
-  ring_buffer_init(&keypad_rb, keypad_buffer, KEYPAD_BUFFER_LEN);
   keypad_init(&keypad);
 
   room_control_init(&room_system);
+  display_scheduler_init(DISPLAY_MAX_FPS, DISPLAY_KEY_LATENCY_MS);
   /* USER CODE END 2 */
 
   /* Infinite loop */
@@ -227,22 +264,35 @@ int main(void)
 
     heartbeat(); // Call the heartbeat function to toggle the LED
 
-    // Actualizar la lógica del sistema (incluye display)
-    room_control_update(&room_system);
-
-    // Keypad funcionalidad
-    if (keypad_interrupt_pin != 0)
+    // Primero las entradas, así lo que cambian se dibuja y se envía en esta misma vuelta
+    // Keypad funcionalidad: se vacía de una vez la cola que llena el SysTick
+    keypad_event_t key_events[KEYPAD_EVENT_QUEUE_LEN];
+    uint8_t key_count = keypad_get_events(key_events, KEYPAD_EVENT_QUEUE_LEN);
+    for (uint8_t i = 0; i < key_count; i++)
     {
-      char key = keypad_scan(&keypad, keypad_interrupt_pin);
-      if (key != '\0')
+      if (key_events[i].type == KEYPAD_EVENT_PRESS)
+      {
+        // El eco de la tecla lo dan los widgets de room_control (asteriscos),
+        // borrar la pantalla aquí dejaría sus celdas desactualizadas
+        key_latency_key(&key_events[i]);
+        room_control_process_key(&room_system, key_events[i].key);
+        key_latency_processed();
+      }
+      else if (key_events[i].type == KEYPAD_EVENT_LONG_PRESS)
       {
-        write_to_oled(&key, White, 31, 31);
-        room_control_process_key(&room_system, key);
+        room_control_process_long_press(&room_system, key_events[i].key);
       }
-      keypad_interrupt_pin = 0;
     }
 
     command_parser(); // Procesar comandos de UART2 y UART3
+
+    // Actualizar la lógica del sistema (incluye display)
+    key_latency_before_draw();
+    room_control_update(&room_system);
+
+    // Enviar al OLED los cambios acumulados, como máximo DISPLAY_MAX_FPS veces por segundo
+    display_scheduler_run();
+    key_latency_poll(); // Tiempo de tecla a pantalla, se consulta con GET_LATENCY
     /* USER CODE END WHILE */
 
     /* USER CODE BEGIN 3 */
@@ -535,11 +585,24 @@ static void MX_DMA_Init(void)
 
   /* DMA controller clock enable */
   __HAL_RCC_DMA1_CLK_ENABLE();
+  __HAL_RCC_DMA2_CLK_ENABLE();
 
   /* DMA interrupt init */
+  /* DMA1_Channel2_IRQn interrupt configuration */
+  HAL_NVIC_SetPriority(DMA1_Channel2_IRQn, 0, 0);
+  HAL_NVIC_EnableIRQ(DMA1_Channel2_IRQn);
+  /* DMA1_Channel3_IRQn interrupt configuration */
+  HAL_NVIC_SetPriority(DMA1_Channel3_IRQn, 0, 0);
+  HAL_NVIC_EnableIRQ(DMA1_Channel3_IRQn);
   /* DMA1_Channel6_IRQn interrupt configuration */
   HAL_NVIC_SetPriority(DMA1_Channel6_IRQn, 0, 0);
   HAL_NVIC_EnableIRQ(DMA1_Channel6_IRQn);
+  /* DMA1_Channel7_IRQn interrupt configuration */
+  HAL_NVIC_SetPriority(DMA1_Channel7_IRQn, 0, 0);
+  HAL_NVIC_EnableIRQ(DMA1_Channel7_IRQn);
+  /* DMA2_Channel7_IRQn interrupt configuration */
+  HAL_NVIC_SetPriority(DMA2_Channel7_IRQn, 0, 0);
+  HAL_NVIC_EnableIRQ(DMA2_Channel7_IRQn);
 }
 
 /**
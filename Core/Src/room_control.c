@@ -6,6 +6,11 @@ extern UART_HandleTypeDef huart3; // Para ESP-01
 #include "room_control.h"
 #include "ssd1306.h"
 #include "ssd1306_fonts.h"
+#include "room_screens.h"
+#include "ssd1306_widgets.h"
+#include "display_scheduler.h"
+#include "event_log.h"
+#include "uart_tx.h"
 #include <string.h>
 #include <stdio.h>
 #include "led.h"
@@ -26,6 +31,22 @@ static void room_control_update_fan(room_control_t *room);
 static fan_level_t room_control_calculate_fan_level(float temperature);
 static void room_control_clear_input(room_control_t *room);
 static uint8_t map_fan_level_to_brightness(fan_level_t level);
+static int32_t room_control_widget_temperature(const void *ctx);
+static int32_t room_control_widget_fan_level(const void *ctx);
+
+// Widgets de la pantalla ligados a los campos de room_control_t.
+// Cada actualización solo redibuja las celdas cuyo valor cambió.
+static SSD1306_Widget_t widget_password;     // Asteriscos de la clave
+static SSD1306_Widget_t widget_temperature;  // Valor tras "Temp: "
+static SSD1306_Widget_t widget_fan;          // Valor tras "FAN: "
+static SSD1306_Widget_t widget_fan_bar;      // Nivel del ventilador en barra
+
+// Estado cuya pantalla fija está cargada en el framebuffer
+static room_state_t displayed_state;
+static bool display_loaded = false;
+
+// Asteriscos de la clave que ya están en el panel
+static uint8_t password_shown = 0;
 
 /**
  * @brief Limpia el buffer de entrada y el índice
@@ -49,6 +70,14 @@ void room_control_init(room_control_t *room) {
     
     // Display
     room->display_update_needed = true;
+    display_loaded = false;
+    ssd1306_WidgetLabel(&widget_password, 10, 30, &Font_11x18, 10, room->display_buffer);
+    ssd1306_WidgetNumber(&widget_temperature, 5 + 6 * 11, 10, &Font_11x18, 5, "%ld C",
+                         room_control_widget_temperature, room);
+    ssd1306_WidgetNumber(&widget_fan, 5 + 5 * 11, 35, &Font_11x18, 3, "%ld",
+                         room_control_widget_fan_level, room);
+    ssd1306_WidgetBar(&widget_fan_bar, 96, 38, 30, 12, FAN_LEVEL_OFF, FAN_LEVEL_HIGH,
+                      room_control_widget_fan_level, room);
     
     // Inicializar hardware (door lock, fan PWM, etc.)
     HAL_GPIO_WritePin(DOOR_STATUS_GPIO_Port, DOOR_STATUS_Pin, GPIO_PIN_RESET);
@@ -82,8 +111,7 @@ void room_control_update(room_control_t *room) {
         }
 
         case ROOM_STATE_UNLOCKED:
-            // Actualización de display para que el mensaje cambie automáticamente
-            room->display_update_needed = true;
+            // Los widgets siguen la temperatura y el ventilador en cada pasada
             break;
 
         case ROOM_STATE_ACCESS_DENIED:
@@ -105,10 +133,7 @@ void room_control_update(room_control_t *room) {
     uint8_t led_brightness = map_fan_level_to_brightness(room->current_fan_level);
     set_led_brightness(room->led, led_brightness);
 
-    if (room->display_update_needed) {
-        room_control_update_display(room);
-        room->display_update_needed = false;
-    }
+    room_control_update_display(room);
 }
 
 
@@ -181,9 +206,15 @@ void room_control_process_key(room_control_t *room, char key) {
             break;
 
         case ROOM_STATE_UNLOCKED:
-            // Tecla '*' para volver a bloquear
-            if (key == '*') {
-                room_control_change_state(room, ROOM_STATE_LOCKED);
+            // La tecla '*' bloquea al mantenerla, ver room_control_process_long_press()
+            if (key == 'D') {
+                // Tecla 'D' muestra u oculta el registro de eventos
+                if (event_log_is_visible()) {
+                    event_log_hide();
+                    display_loaded = false;
+                } else {
+                    event_log_show();
+                }
             }
             break;
 
@@ -194,6 +225,22 @@ void room_control_process_key(room_control_t *room, char key) {
     room->display_update_needed = true;
 }
 
+/**
+ * @brief Procesa una tecla mantenida presionada (KEYPAD_EVENT_LONG_PRESS)
+ * @param room Puntero a la estructura de control de la habitación
+ * @param key Tecla mantenida
+ */
+void room_control_process_long_press(room_control_t *room, char key) {
+    room->last_input_time = HAL_GetTick();
+
+    // Mantener '*' vuelve a bloquear; una pulsación corta no, para no
+    // bloquear por accidente
+    if (room->current_state == ROOM_STATE_UNLOCKED && key == '*') {
+        room_control_change_state(room, ROOM_STATE_LOCKED);
+        room->display_update_needed = true;
+    }
+}
+
 /**
  * @brief Establece la temperatura actual y actualiza el ventilador si es necesario
  * @param room Puntero a la estructura de control de la habitación
@@ -206,6 +253,13 @@ void room_control_set_temperature(room_control_t *room, float temperature) {
     if (!room->manual_fan_override) {
         fan_level_t new_level = room_control_calculate_fan_level(temperature);
         if (new_level != room->current_fan_level) {
+            char event[EVENT_LOG_LINE_CHARS + 1];
+            snprintf(event, sizeof(event), "FAN AUTO %d%%", (int)new_level);
+            event_log_add(event);
+            if (new_level == FAN_LEVEL_HIGH) {
+                snprintf(event, sizeof(event), "ALERTA TEMP %dC", (int)temperature);
+                event_log_add(event);
+            }
             room->current_fan_level = new_level;
             room->display_update_needed = true;
         }
@@ -226,6 +280,9 @@ bool room_control_force_fan(room_control_t *room, int level) {
             case 2: room->current_fan_level = FAN_LEVEL_MED; break;
             case 3: room->current_fan_level = FAN_LEVEL_HIGH; break;
         }
+        char event[EVENT_LOG_LINE_CHARS + 1];
+        snprintf(event, sizeof(event), "FAN MANUAL %d%%", (int)room->current_fan_level);
+        event_log_add(event);
         room->display_update_needed = true;
         return true;
     }
@@ -247,6 +304,7 @@ void room_control_force_fan_level(room_control_t *room, fan_level_t level) {
 bool room_control_change_password(room_control_t *room, const char *new_password) {
     if (strlen(new_password) == PASSWORD_LENGTH) {
         strcpy(room->password, new_password);
+        event_log_add("CLAVE CAMBIADA");
         return true;
     }
     return false;
@@ -275,6 +333,9 @@ float room_control_get_temperature(room_control_t *room) {
  * @param new_state Nuevo estado a establecer
  */
 static void room_control_change_state(room_control_t *room, room_state_t new_state) {
+    if (room->current_state == ROOM_STATE_UNLOCKED && new_state == ROOM_STATE_LOCKED) {
+        event_log_add("PUERTA CERRADA");
+    }
     room->current_state = new_state;
     room->state_enter_time = HAL_GetTick();
     room->display_update_needed = true;
@@ -294,6 +355,7 @@ static void room_control_change_state(room_control_t *room, room_state_t new_sta
             break;
 
         case ROOM_STATE_UNLOCKED:
+            event_log_add("ACCESO OK");
             room->door_locked = false;
             room->manual_fan_override = false;  // Reset manual override
             // Enciende el indicador de acceso
@@ -301,6 +363,7 @@ static void room_control_change_state(room_control_t *room, room_state_t new_sta
             break;
 
         case ROOM_STATE_ACCESS_DENIED:
+            event_log_add("ACCESO DENEGADO");
             room_control_clear_input(room);
             // Apaga el indicador de acceso
             HAL_GPIO_WritePin(DOOR_STATUS_GPIO_Port, DOOR_STATUS_Pin, GPIO_PIN_RESET);
@@ -308,7 +371,7 @@ static void room_control_change_state(room_control_t *room, room_state_t new_sta
             // Enviar alerta por ESP-01 (USART3)
 
             char alert_msg[] = "POST /alert HTTP/1.1\r\nHost: mi-servidor.com\r\n\r\nAcceso denegado detectado\r\n";
-            HAL_UART_Transmit(&huart3, (uint8_t*)alert_msg, strlen(alert_msg), 1000);
+            uart_send(&huart3, alert_msg, strlen(alert_msg)); // Sin esperar al ESP-01
             break;
 
         default:
@@ -321,49 +384,82 @@ static void room_control_change_state(room_control_t *room, room_state_t new_sta
  * @param room Puntero a la estructura de control de la habitación
  */
 static void room_control_update_display(room_control_t *room) {
-    ssd1306_Fill(Black);
-
-    switch (room->current_state) {
-        case ROOM_STATE_LOCKED: {
-            ssd1306_SetCursor(10, 10);
-            ssd1306_WriteString("SISTEMA", Font_11x18, White);
-            ssd1306_SetCursor(10, 30);
-            ssd1306_WriteString("BLOQUEADO", Font_11x18, White);
-            break;
+    bool changed = false;
+
+    // El registro de eventos ocupa la pantalla mientras la puerta siga abierta
+    if (event_log_is_visible()) {
+        if (room->current_state == ROOM_STATE_UNLOCKED) {
+            event_log_update();
+            room->display_update_needed = false;
+            return;
         }
-        case ROOM_STATE_INPUT_PASSWORD: {
-            ssd1306_SetCursor(10, 10);
-            ssd1306_WriteString("CLAVE: ", Font_11x18, White);
-            ssd1306_SetCursor(10, 30);
-            ssd1306_WriteString(room->display_buffer, Font_11x18, White);
-            break;
+        event_log_hide();
+        display_loaded = false;
+    }
+
+    // Al cambiar de estado se carga su pantalla fija, precompilada en flash
+    // (room_screens.c), y se redibujan completos los widgets que la acompañan
+    if (!display_loaded || room->current_state != displayed_state) {
+        switch (room->current_state) {
+            case ROOM_STATE_LOCKED:         ssd1306_LoadScreen(room_screen_locked); break;
+            case ROOM_STATE_INPUT_PASSWORD: ssd1306_LoadScreen(room_screen_password); break;
+            case ROOM_STATE_UNLOCKED:       ssd1306_LoadScreen(room_screen_unlocked); break;
+            case ROOM_STATE_ACCESS_DENIED:  ssd1306_LoadScreen(room_screen_denied); break;
+            default:                        ssd1306_Fill(Black); break;
         }
-        case ROOM_STATE_UNLOCKED: {
-            char temp_str[24];
-            snprintf(temp_str, sizeof(temp_str), "Temp: %d C", (int)(room->current_temperature));
-            ssd1306_SetCursor(5, 10);
-            ssd1306_WriteString(temp_str, Font_11x18, White);
-
-            // Mostrar el nivel forzado si está activo, si no, el calculado
-            int nivel_a_mostrar = room->manual_fan_override ? room->current_fan_level : room_control_calculate_fan_level(room->current_temperature);
-            char fan_str[32];
-            snprintf(fan_str, sizeof(fan_str), "FAN: %d", nivel_a_mostrar);
-            ssd1306_SetCursor(5, 35);
-            ssd1306_WriteString(fan_str, Font_11x18, White);
+        ssd1306_WidgetInvalidate(&widget_password);
+        ssd1306_WidgetInvalidate(&widget_temperature);
+        ssd1306_WidgetInvalidate(&widget_fan);
+        ssd1306_WidgetInvalidate(&widget_fan_bar);
+        displayed_state = room->current_state;
+        display_loaded = true;
+        password_shown = 0;
+        changed = true;
+    }
+
+    // Campos dinámicos: solo se redibujan las celdas que cambiaron
+    switch (room->current_state) {
+        case ROOM_STATE_INPUT_PASSWORD:
+            if (ssd1306_WidgetUpdate(&widget_password) > 0) {
+                if (!changed && room->input_index == password_shown + 1) {
+                    // Solo apareció un asterisco: se envía su celda y nada más
+                    uint8_t cell_width = widget_password.Font->width;
+                    ssd1306_UpdateRegion(widget_password.X + password_shown * cell_width, widget_password.Y,
+                                         cell_width, widget_password.Font->height);
+                    room->display_update_needed = false;
+                } else {
+                    changed = true;
+                }
+                password_shown = room->input_index;
+            }
             break;
-        }
-        case ROOM_STATE_ACCESS_DENIED: {
-            ssd1306_SetCursor(5, 10);
-            ssd1306_WriteString("ACCESO", Font_11x18, White);
-            ssd1306_SetCursor(5, 35);
-            ssd1306_WriteString("DENEGADO", Font_11x18, White);
+        case ROOM_STATE_UNLOCKED:
+            changed |= ssd1306_WidgetUpdate(&widget_temperature) > 0;
+            changed |= ssd1306_WidgetUpdate(&widget_fan) > 0;
+            changed |= ssd1306_WidgetUpdate(&widget_fan_bar) > 0;
             break;
-        }
         default:
             break;
     }
 
-    ssd1306_UpdateScreen();
+    // El envío al panel lo agrupa y limita display_scheduler; los cambios pedidos
+    // por el usuario (teclas, cambios de estado) son urgentes
+    if (changed || room->display_update_needed) {
+        display_request_refresh(room->display_update_needed);
+        room->display_update_needed = false;
+    }
+}
+
+// Valores ligados a los widgets
+static int32_t room_control_widget_temperature(const void *ctx) {
+    const room_control_t *room = (const room_control_t *)ctx;
+    return (int32_t)room->current_temperature;
+}
+
+static int32_t room_control_widget_fan_level(const void *ctx) {
+    // Mostrar el nivel forzado si está activo, si no, el calculado
+    const room_control_t *room = (const room_control_t *)ctx;
+    return room->manual_fan_override ? room->current_fan_level : room_control_calculate_fan_level(room->current_temperature);
 }
 
 /**
@@ -0,0 +1,192 @@
+#include "uart_rx.h"
+#include <string.h>
+
+/*
+ * Recepción por DMA circular con HAL_UARTEx_ReceiveToIdle_DMA(): el DMA llena
+ * el buffer sin intervención de la CPU y HAL_UARTEx_RxEventCallback() avisa en
+ * la mitad, al final y cuando la línea queda inactiva (IDLE) con la posición
+ * hasta la que escribió. Cada aviso arma las líneas desde la posición anterior.
+ */
+typedef struct {
+    UART_HandleTypeDef *huart;
+    uart_rx_line_handler_t on_line;
+    uint8_t dma_buffer[UART_RX_DMA_SIZE];
+    uint16_t last_pos;              // Primer byte del buffer del DMA sin procesar
+    char line[UART_RX_LINE_SIZE];
+    uint8_t line_len;
+    bool line_long;
+    bool line_broken;               // Hubo un error de recepción en esta línea
+    uart_rx_stats_t stats;
+} uart_rx_port_t;
+
+static uart_rx_port_t ports[UART_RX_PORTS];
+
+static uart_rx_port_t *find_port(UART_HandleTypeDef *huart) {
+    for (uint8_t i = 0; i < UART_RX_PORTS; i++) {
+        if (ports[i].huart == huart) {
+            return &ports[i];
+        }
+    }
+    return NULL;
+}
+
+static void end_line(uart_rx_port_t *port) {
+    if (port->line_broken) {
+        port->stats.dropped_lines++;
+    } else if (port->line_len > 0) {
+        port->line[port->line_len] = '\0';
+        if (port->line_long) {
+            port->stats.long_lines++;
+        }
+        port->stats.lines++;
+        port->on_line(port->huart, port->line);
+    }
+    port->line_len = 0;
+    port->line_long = false;
+    port->line_broken = false;
+}
+
+static void assemble(uart_rx_port_t *port, const uint8_t *data, uint16_t len) {
+    port->stats.bytes += len;
+    for (uint16_t i = 0; i < len; i++) {
+        uint8_t c = data[i];
+        if (c == '\r' || c == '\n') {
+            end_line(port);     // En "\r\n" la segunda llega con la línea vacía y no se entrega
+        } else if (port->line_len < UART_RX_LINE_SIZE - 1) {
+            port->line[port->line_len++] = c;
+        } else {
+            port->line_long = true;
+        }
+    }
+}
+
+// Contador de ciclos del DWT para medir el tiempo dentro de la interrupción
+static void cycle_counter_init(void) {
+    if (!(DWT->CTRL & DWT_CTRL_CYCCNTENA_Msk)) {
+        CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+        DWT->CYCCNT = 0;
+        DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+    }
+}
+
+static void isr_time(uart_rx_port_t *port, uint32_t start) {
+    uint32_t cycles = DWT->CYCCNT - start;
+    if (cycles > port->stats.isr_max_cycles) {
+        port->stats.isr_max_cycles = cycles;
+    }
+}
+
+static bool arm(uart_rx_port_t *port) {
+    port->last_pos = 0;
+    return HAL_UARTEx_ReceiveToIdle_DMA(port->huart, port->dma_buffer, UART_RX_DMA_SIZE) == HAL_OK;
+}
+
+/**
+ * @brief Registra el puerto y arranca la recepción continua por DMA
+ * @param huart UART con el canal de DMA de recepción en modo circular
+ * @param on_line Destino de las líneas completas
+ * @return false si no quedan puertos libres o la HAL rechazó el arranque
+ */
+bool uart_rx_start(UART_HandleTypeDef *huart, uart_rx_line_handler_t on_line) {
+    uart_rx_port_t *port = find_port(huart);
+    if (port == NULL) {
+        port = find_port(NULL);
+        if (port == NULL) {
+            return false;
+        }
+    }
+    cycle_counter_init();
+    memset(port, 0, sizeof(*port));
+    port->huart = huart;
+    port->on_line = on_line;
+    return arm(port);
+}
+
+// Arma las líneas con lo que escribió el DMA desde el aviso anterior
+static void consume(uart_rx_port_t *port, uint16_t pos) {
+    if (pos > UART_RX_DMA_SIZE) {
+        return;
+    }
+    if (pos < port->last_pos) {
+        // Se perdió el aviso del final: lo que queda hasta el final va primero
+        assemble(port, &port->dma_buffer[port->last_pos], UART_RX_DMA_SIZE - port->last_pos);
+        port->last_pos = 0;
+    }
+    if (pos > port->last_pos) {
+        assemble(port, &port->dma_buffer[port->last_pos], pos - port->last_pos);
+    }
+    port->last_pos = (pos == UART_RX_DMA_SIZE) ? 0 : pos;
+}
+
+/**
+ * @brief Llamar desde HAL_UARTEx_RxEventCallback(). Procesa a lo sumo
+ *        UART_RX_DMA_SIZE bytes y entrega las líneas al manejador, que solo
+ *        debe encolarlas: así el peor tiempo en la interrupción queda acotado
+ * @param pos Posición del buffer hasta la que escribió el DMA (UART_RX_DMA_SIZE al dar la vuelta)
+ */
+void uart_rx_event(UART_HandleTypeDef *huart, uint16_t pos) {
+    uint32_t start = DWT->CYCCNT;
+    uart_rx_port_t *port = find_port(huart);
+    if (port != NULL) {
+        consume(port, pos);
+        isr_time(port, start);
+    }
+}
+
+/**
+ * @brief Llamar desde HAL_UART_ErrorCallback(). En recepción por DMA la HAL
+ *        detiene la transferencia ante cualquier error: se cuentan, se procesa
+ *        lo que alcanzó a llegar, se descarta la línea afectada y se relanza.
+ */
+void uart_rx_error(UART_HandleTypeDef *huart) {
+    uint32_t start = DWT->CYCCNT;
+    uart_rx_port_t *port = find_port(huart);
+    if (port == NULL) {
+        return;
+    }
+
+    uint32_t error = huart->ErrorCode;
+    if (error & HAL_UART_ERROR_ORE) {
+        port->stats.overrun++;
+    }
+    if (error & HAL_UART_ERROR_FE) {
+        port->stats.framing++;
+    }
+    if (error & HAL_UART_ERROR_NE) {
+        port->stats.noise++;
+    }
+    if (error & HAL_UART_ERROR_PE) {
+        port->stats.parity++;
+    }
+
+    if (huart->RxState != HAL_UART_STATE_READY) {
+        isr_time(port, start);
+        return;     // La recepción sigue activa, no hay nada que relanzar
+    }
+
+    // El canal detenido conserva en su contador lo que faltaba por escribir
+    uint16_t pos = UART_RX_DMA_SIZE - __HAL_DMA_GET_COUNTER(huart->hdmarx);
+    consume(port, pos);
+    // La línea a medias quedó con un byte dañado; tras un overrun, además, la
+    // siguiente puede haber perdido su comienzo
+    if (port->line_len > 0 || (error & HAL_UART_ERROR_ORE)) {
+        port->line_broken = true;
+    }
+
+    port->stats.restarts++;
+    arm(port);
+    isr_time(port, start);
+}
+
+/**
+ * @brief Copia los contadores de un puerto
+ * @return false si el puerto no se arrancó con uart_rx_start()
+ */
+bool uart_rx_get_stats(UART_HandleTypeDef *huart, uart_rx_stats_t *stats) {
+    uart_rx_port_t *port = find_port(huart);
+    if (port == NULL) {
+        return false;
+    }
+    *stats = port->stats;
+    return true;
+}
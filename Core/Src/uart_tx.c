@@ -0,0 +1,195 @@
+#include "uart_tx.h"
+#include "ring_buffer.h"
+#include <string.h>
+
+/*
+ * Envío por DMA desde una cola circular por puerto. uart_send() copia el
+ * mensaje y vuelve; si el DMA está parado lo arranca con el tramo contiguo que
+ * empieza en el primer byte pendiente. Al terminar cada transferencia,
+ * HAL_UART_TxCpltCallback() libera ese tramo y encadena el siguiente (lo que
+ * llegó mientras tanto o la parte que dio la vuelta al final del buffer).
+ *
+ * Los bytes en vuelo siguen en la cola hasta que el DMA termina, así que el
+ * productor nunca pisa lo que se está enviando.
+ */
+typedef struct {
+    UART_HandleTypeDef *huart;
+    uart_tx_policy_t policy;
+    ring_buffer_t queue;
+    uint8_t buffer[UART_TX_BUFFER_SIZE];
+    volatile bool busy;         // Hay una transferencia de DMA en curso
+    uint16_t in_flight;         // Largo de esa transferencia
+    uint32_t window_start;
+    uint32_t window_bytes;
+    uart_tx_stats_t stats;
+} uart_tx_port_t;
+
+static uart_tx_port_t ports[UART_TX_PORTS];
+
+static uart_tx_port_t *find_port(UART_HandleTypeDef *huart) {
+    for (uint8_t i = 0; i < UART_TX_PORTS; i++) {
+        if (ports[i].huart == huart) {
+            return &ports[i];
+        }
+    }
+    return NULL;
+}
+
+// Arranca el DMA con el siguiente tramo pendiente. Con interrupciones deshabilitadas o desde la del DMA.
+static void kick(uart_tx_port_t *port) {
+    uint8_t *data;
+    if (port->busy) {
+        return;
+    }
+    uint16_t len = ring_buffer_get_read_span(&port->queue, &data);
+    if (len == 0) {
+        return;
+    }
+    if (HAL_UART_Transmit_DMA(port->huart, data, len) == HAL_OK) {
+        port->busy = true;
+        port->in_flight = len;
+        port->stats.transfers++;
+    }
+}
+
+static void update_rate(uart_tx_port_t *port, uint32_t now) {
+    uint32_t elapsed = now - port->window_start;
+    if (elapsed >= UART_TX_RATE_WINDOW_MS) {
+        port->stats.rate = port->window_bytes * 1000 / elapsed;
+        if (port->stats.rate > port->stats.max_rate) {
+            port->stats.max_rate = port->stats.rate;
+        }
+        port->window_bytes = 0;
+        port->window_start = now;
+    }
+}
+
+// Encola lo que cabe de data (o nada si no cabe entero y all_or_nothing)
+static uint16_t enqueue(uart_tx_port_t *port, const uint8_t *data, uint16_t len, bool all_or_nothing) {
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    uint16_t written = 0;
+    if (!all_or_nothing || UART_TX_BUFFER_SIZE - ring_buffer_count(&port->queue) >= len) {
+        written = ring_buffer_write_n(&port->queue, data, len);
+    }
+    port->stats.queued += written;
+    uint16_t backlog = ring_buffer_count(&port->queue);
+    if (backlog > port->stats.max_backlog) {
+        port->stats.max_backlog = backlog;
+    }
+    kick(port);
+    __set_PRIMASK(primask);
+    return written;
+}
+
+/**
+ * @brief Registra el puerto con su política de cola llena
+ * @param huart UART con el canal de DMA de transmisión configurado
+ * @return false si no quedan puertos libres
+ */
+bool uart_tx_init(UART_HandleTypeDef *huart, uart_tx_policy_t policy) {
+    uart_tx_port_t *port = find_port(huart);
+    if (port == NULL) {
+        port = find_port(NULL);
+        if (port == NULL) {
+            return false;
+        }
+    }
+    memset(port, 0, sizeof(*port));
+    port->huart = huart;
+    port->policy = policy;
+    port->window_start = HAL_GetTick();
+    ring_buffer_init(&port->queue, port->buffer, UART_TX_BUFFER_SIZE);
+    return true;
+}
+
+/**
+ * @brief Encola un mensaje para enviarlo por DMA y vuelve sin esperar al envío
+ * @param huart UART registrada con uart_tx_init()
+ * @param data Bytes a enviar, se copian
+ * @param len Cantidad de bytes
+ * @return true si se encoló el mensaje completo
+ */
+bool uart_send(UART_HandleTypeDef *huart, const void *data, uint16_t len) {
+    uart_tx_port_t *port = find_port(huart);
+    if (port == NULL) {
+        return false;
+    }
+
+    const uint8_t *bytes = data;
+    uint16_t left = len;
+    // En una interrupción no se puede esperar: el DMA no termina hasta salir de ella
+    if (port->policy == UART_TX_WAIT && __get_IPSR() == 0) {
+        uint32_t start = HAL_GetTick();
+        for (;;) {
+            uint16_t written = enqueue(port, bytes, left, false);
+            bytes += written;
+            left -= written;
+            if (left == 0 || HAL_GetTick() - start >= UART_TX_WAIT_MS) {
+                break;
+            }
+        }
+    } else {
+        left -= enqueue(port, bytes, left, true);
+    }
+
+    if (left > 0) {
+        uint32_t primask = __get_PRIMASK();
+        __disable_irq();
+        port->stats.dropped += left;
+        port->stats.dropped_msgs++;
+        __set_PRIMASK(primask);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Llamar desde HAL_UART_TxCpltCallback(): libera el tramo enviado y encadena el siguiente
+ */
+void uart_tx_complete(UART_HandleTypeDef *huart) {
+    uart_tx_port_t *port = find_port(huart);
+    if (port == NULL || !port->busy) {
+        return;
+    }
+    ring_buffer_commit_read(&port->queue, port->in_flight);
+    port->stats.sent += port->in_flight;
+    port->window_bytes += port->in_flight;
+    port->busy = false;
+    update_rate(port, HAL_GetTick());
+    kick(port);
+}
+
+/**
+ * @brief Llamar desde HAL_UART_ErrorCallback(). Si la transmisión se detuvo,
+ *        se descarta el tramo en vuelo y se sigue con el resto de la cola.
+ */
+void uart_tx_error(UART_HandleTypeDef *huart) {
+    uart_tx_port_t *port = find_port(huart);
+    if (port == NULL || !port->busy || huart->gState != HAL_UART_STATE_READY) {
+        return;
+    }
+    port->stats.errors++;
+    port->stats.dropped += port->in_flight;
+    ring_buffer_commit_read(&port->queue, port->in_flight);
+    port->busy = false;
+    kick(port);
+}
+
+/**
+ * @brief Copia los contadores de un puerto, con la cola y el caudal actuales
+ * @return false si el puerto no se registró con uart_tx_init()
+ */
+bool uart_tx_get_stats(UART_HandleTypeDef *huart, uart_tx_stats_t *stats) {
+    uart_tx_port_t *port = find_port(huart);
+    if (port == NULL) {
+        return false;
+    }
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    update_rate(port, HAL_GetTick());
+    port->stats.backlog = ring_buffer_count(&port->queue);
+    *stats = port->stats;
+    __set_PRIMASK(primask);
+    return true;
+}
@@ -7,63 +7,270 @@ static const char keypad_map[KEYPAD_ROWS][KEYPAD_COLS] = {
   {'*', '0', '#', 'D'}
 };
 
-static uint32_t last_press_time = 0;
+#define KEYPAD_KEYS (KEYPAD_ROWS * KEYPAD_COLS)
+#define KEYPAD_ROW_MASK ((1u << KEYPAD_COLS) - 1)
 
-static void small_delay(void) {
-    for (volatile int i = 0; i < 1000; i++);
+// Puertos distintos de las columnas: cada fila se muestrea con una lectura de
+// IDR por puerto (una sola si las cuatro columnas comparten puerto)
+static GPIO_TypeDef* col_port_list[KEYPAD_COLS];
+static uint8_t col_port_count = 0;
+static uint8_t col_port_index[KEYPAD_COLS];
+
+// Pedido de barrido desde la EXTI de una columna, lo atiende el siguiente tick
+static volatile bool scan_requested = false;
+static volatile uint32_t wake_time = 0;    // HAL_GetTick() de la primera EXTI del pedido
+
+// Estado del barrido, solo lo toca keypad_tick()
+static bool scanning = false;
+static uint8_t scan_row = 0;
+static uint16_t raw_keys = 0;       // Teclas leídas en la pasada en curso
+static uint16_t stable_keys = 0;    // Teclas presionadas tras el antirrebote
+static uint8_t debounce[KEYPAD_KEYS];
+static uint32_t edge_time[KEYPAD_KEYS]; // Inicio del cambio que se está confirmando
+static bool first_pass = false;         // Primera pasada tras la EXTI: el flanco es wake_time
+static uint32_t press_time[KEYPAD_KEYS];
+static uint32_t repeat_time[KEYPAD_KEYS];
+static uint16_t long_keys = 0;          // Teclas que ya dieron KEYPAD_EVENT_LONG_PRESS
+
+// Cola de eventos: la llena el tick (interrupción), la vacía el lazo principal,
+// sin deshabilitar interrupciones. Llena, se conserva lo ya encolado y se
+// cuenta la pérdida.
+RECORD_QUEUE_DEFINE(keypad_queue, keypad_event_t, KEYPAD_EVENT_QUEUE_LEN, RECORD_QUEUE_REJECT_NEW)
+static keypad_queue_t events;
+
+static void keypad_push_event(uint8_t index, keypad_event_type_t type) {
+    keypad_event_t event = {
+        .key = keypad_map[index / KEYPAD_COLS][index % KEYPAD_COLS],
+        .type = type,
+        .edge_time = edge_time[index],
+        .time = HAL_GetTick(),
+    };
+    keypad_queue_push(&events, &event);
 }
 
-void keypad_init(keypad_handle_t* keypad) {
+// Todas las filas en bajo: cualquier tecla lleva su columna a bajo y dispara la EXTI
+static void keypad_rows_idle(keypad_handle_t* keypad) {
     for (int i = 0; i < KEYPAD_ROWS; i++) {
-        HAL_GPIO_WritePin(keypad->row_ports[i], keypad->row_pins[i], GPIO_PIN_RESET);
+        keypad->row_ports[i]->BRR = keypad->row_pins[i];
+    }
+}
+
+/**
+ * @brief Agrupa las columnas por puerto y deja las filas en reposo (en bajo),
+ *        a la espera de la EXTI que pide el barrido.
+ */
+void keypad_init(keypad_handle_t* keypad) {
+    col_port_count = 0;
+    for (int col = 0; col < KEYPAD_COLS; col++) {
+        uint8_t p = 0;
+        while (p < col_port_count && col_port_list[p] != keypad->col_ports[col]) {
+            p++;
+        }
+        if (p == col_port_count) {
+            col_port_list[col_port_count++] = keypad->col_ports[col];
+        }
+        col_port_index[col] = p;
+    }
+    keypad_rows_idle(keypad);
+}
+
+// Columnas en bajo (teclas presionadas) de la fila activa, bit 0 = columna 0
+static uint16_t keypad_read_columns(keypad_handle_t* keypad) {
+    uint32_t idr[KEYPAD_COLS];
+    for (uint8_t p = 0; p < col_port_count; p++) {
+        idr[p] = col_port_list[p]->IDR;
+    }
+
+    uint16_t cols = 0;
+    for (int col = 0; col < KEYPAD_COLS; col++) {
+        if (!(idr[col_port_index[col]] & keypad->col_pins[col])) {
+            cols |= 1u << col;
+        }
     }
+    return cols;
 }
 
-char keypad_scan(keypad_handle_t* keypad, uint16_t col_pin) {
-    char key_pressed = '\0';
-    
-    if (HAL_GetTick() - last_press_time < 100) {
-        return '\0';
+/*
+ * Sin diodos, tres teclas en las esquinas de un rectángulo hacen aparecer la
+ * cuarta. Una pasada con dos filas que comparten dos o más columnas es ambigua
+ * y se descarta; cualquier otra combinación se resuelve completa.
+ */
+static bool keypad_is_ghost(uint16_t raw) {
+    for (int r1 = 0; r1 < KEYPAD_ROWS; r1++) {
+        for (int r2 = r1 + 1; r2 < KEYPAD_ROWS; r2++) {
+            uint16_t common = (raw >> (r1 * KEYPAD_COLS)) & (raw >> (r2 * KEYPAD_COLS)) & KEYPAD_ROW_MASK;
+            if (common & (common - 1)) {
+                return true;
+            }
+        }
     }
-    
-    small_delay();
-    
-    int col_index = -1;
+    return false;
+}
+
+/**
+ * @brief Llamar desde HAL_GPIO_EXTI_Callback() con el pin de la columna.
+ *        No lee nada: solo despierta al barrido si estaba detenido.
+ */
+void keypad_irq(keypad_handle_t* keypad, uint16_t col_pin) {
     for (int i = 0; i < KEYPAD_COLS; i++) {
         if (keypad->col_pins[i] == col_pin) {
-            col_index = i;
-            break;
+            if (!scan_requested) {
+                wake_time = HAL_GetTick();
+                scan_requested = true;
+            }
+            return;
         }
     }
-    
-    if (col_index == -1) {
-        return '\0';
+}
+
+// Integra la pasada completa en los contadores y genera los eventos
+static void keypad_debounce(uint16_t raw) {
+    for (int row = 0; row < KEYPAD_ROWS; row++) {
+        for (int col = 0; col < KEYPAD_COLS; col++) {
+            uint8_t index = row * KEYPAD_COLS + col;
+            uint16_t bit = KEYPAD_KEY_BIT(row, col);
+            uint8_t *count = &debounce[index];
+
+            if (raw & bit) {
+                if (*count == 0) {
+                    edge_time[index] = first_pass ? wake_time : HAL_GetTick();
+                }
+                if (*count < KEYPAD_DEBOUNCE_SCANS && ++(*count) == KEYPAD_DEBOUNCE_SCANS && !(stable_keys & bit)) {
+                    stable_keys |= bit;
+                    long_keys &= ~bit;
+                    press_time[index] = HAL_GetTick();
+                    keypad_push_event(index, KEYPAD_EVENT_PRESS);
+                }
+            } else {
+                if (*count == KEYPAD_DEBOUNCE_SCANS) {
+                    edge_time[index] = HAL_GetTick();
+                }
+                if (*count > 0 && --(*count) == 0 && (stable_keys & bit)) {
+                    stable_keys &= ~bit;
+                    keypad_push_event(index, KEYPAD_EVENT_RELEASE);
+                }
+            }
+        }
     }
-    
-    for (int i = 0; i < KEYPAD_ROWS; i++) {
-        HAL_GPIO_WritePin(keypad->row_ports[i], keypad->row_pins[i], GPIO_PIN_SET);
+}
+
+// Tecla mantenida: pulsación larga y después repeticiones
+static void keypad_hold(void) {
+    uint32_t now = HAL_GetTick();
+    for (uint8_t index = 0; index < KEYPAD_KEYS; index++) {
+        uint16_t bit = 1u << index;
+        if (!(stable_keys & bit)) {
+            continue;
+        }
+        if (!(long_keys & bit)) {
+            if (now - press_time[index] >= KEYPAD_LONG_PRESS_MS) {
+                long_keys |= bit;
+                repeat_time[index] = now + KEYPAD_REPEAT_MS;
+                keypad_push_event(index, KEYPAD_EVENT_LONG_PRESS);
+            }
+        } else if ((int32_t)(now - repeat_time[index]) >= 0) {
+            repeat_time[index] += KEYPAD_REPEAT_MS;
+            keypad_push_event(index, KEYPAD_EVENT_REPEAT);
+        }
     }
-    
-    for (int row = 0; row < KEYPAD_ROWS; row++) {
-        HAL_GPIO_WritePin(keypad->row_ports[row], keypad->row_pins[row], GPIO_PIN_RESET);
-        
-        small_delay();
-        
-        if (HAL_GPIO_ReadPin(keypad->col_ports[col_index], keypad->col_pins[col_index]) == GPIO_PIN_RESET) {
-            key_pressed = keypad_map[row][col_index];
-            
-            while (HAL_GPIO_ReadPin(keypad->col_ports[col_index], keypad->col_pins[col_index]) == GPIO_PIN_RESET) {
-                small_delay();
+}
+
+static bool keypad_settled(void) {
+    if (stable_keys != 0) {
+        return false;
+    }
+    for (int i = 0; i < KEYPAD_KEYS; i++) {
+        if (debounce[i] != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Paso del barrido, llamar cada 1 ms desde una interrupción de
+ *        temporizador. Lee las columnas de la fila activada en el tick anterior
+ *        (ya asentadas, sin esperas) y activa la siguiente. Con todas las teclas
+ *        sueltas vuelve al reposo hasta la próxima EXTI.
+ */
+void keypad_tick(keypad_handle_t* keypad) {
+    if (!scanning) {
+        if (!scan_requested) {
+            return;
+        }
+        // Solo una fila en bajo a la vez
+        for (int i = 0; i < KEYPAD_ROWS; i++) {
+            keypad->row_ports[i]->BSRR = keypad->row_pins[i];
+        }
+        scanning = true;
+        first_pass = true;
+        scan_row = 0;
+        raw_keys = 0;
+        keypad->row_ports[0]->BRR = keypad->row_pins[0];
+        return;
+    }
+
+    raw_keys |= keypad_read_columns(keypad) << (scan_row * KEYPAD_COLS);
+    keypad->row_ports[scan_row]->BSRR = keypad->row_pins[scan_row];
+
+    if (++scan_row == KEYPAD_ROWS) {
+        if (!keypad_is_ghost(raw_keys)) {
+            keypad_debounce(raw_keys);
+            first_pass = false;
+        }
+        keypad_hold();
+        scan_row = 0;
+        raw_keys = 0;
+
+        if (keypad_settled()) {
+            // Se borra el pedido antes de bajar las filas: una tecla presionada
+            // desde ahí genera un flanco nuevo y otro pedido. Una que ya estaba
+            // abajo (rebote durante la pasada) no genera flanco, se mira aquí.
+            scanning = false;
+            scan_requested = false;
+            keypad_rows_idle(keypad);
+            if (keypad_read_columns(keypad)) {
+                wake_time = HAL_GetTick();
+                scan_requested = true;
             }
-            
-            last_press_time = HAL_GetTick();
-            break;
+            return;
         }
-        
-        HAL_GPIO_WritePin(keypad->row_ports[row], keypad->row_pins[row], GPIO_PIN_SET);
     }
-    
-    keypad_init(keypad);
-    
-    return key_pressed;
-}
\ No newline at end of file
+
+    keypad->row_ports[scan_row]->BRR = keypad->row_pins[scan_row];
+}
+
+/**
+ * @brief Saca de una vez los eventos pendientes, del más antiguo al más nuevo
+ * @param out Destino, al menos max elementos
+ * @param max Cantidad máxima a sacar
+ * @return Cantidad de eventos copiados
+ */
+uint8_t keypad_get_events(keypad_event_t* out, uint8_t max) {
+    uint8_t n = 0;
+    while (n < max && keypad_queue_pop(&events, &out[n])) {
+        n++;
+    }
+    return n;
+}
+
+/**
+ * @brief Copia los contadores de la cola
+ */
+void keypad_get_queue_stats(keypad_queue_stats_t* stats) {
+    keypad_queue_get_stats(&events, stats);
+}
+
+/**
+ * @brief Indica si el barrido está activo; en reposo el tick no hace nada
+ */
+bool keypad_is_scanning(void) {
+    return scanning;
+}
+
+/**
+ * @brief Mapa de las teclas presionadas tras el antirrebote, ver KEYPAD_KEY_BIT()
+ */
+uint16_t keypad_get_keys(void) {
+    return stable_keys;
+}
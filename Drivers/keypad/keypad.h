@@ -2,11 +2,27 @@
 #define KEYPAD_DRIVER_H
 
 #include "main.h"
+#include "record_queue.h"
 #include <stdint.h>
+#include <stdbool.h>
 
 #define KEYPAD_ROWS 4
 #define KEYPAD_COLS 4
 
+// Lecturas completas iguales que necesita una tecla para cambiar de estado.
+// keypad_tick() avanza una fila por llamada: con el SysTick de 1 ms la matriz
+// completa se lee cada KEYPAD_ROWS ms y el antirrebote dura unos 16 ms
+#define KEYPAD_DEBOUNCE_SCANS   4
+// Eventos que esperan al lazo principal (potencia de 2)
+#define KEYPAD_EVENT_QUEUE_LEN  32
+// Tecla mantenida: KEYPAD_EVENT_LONG_PRESS a los KEYPAD_LONG_PRESS_MS y luego
+// un KEYPAD_EVENT_REPEAT cada KEYPAD_REPEAT_MS hasta soltarla
+#define KEYPAD_LONG_PRESS_MS    800
+#define KEYPAD_REPEAT_MS        200
+
+// Bit de una tecla en el mapa de keypad_get_keys()
+#define KEYPAD_KEY_BIT(row, col) (1u << ((row) * KEYPAD_COLS + (col)))
+
 typedef struct {
     GPIO_TypeDef* row_ports[KEYPAD_ROWS];
     uint16_t row_pins[KEYPAD_ROWS];
@@ -14,7 +30,29 @@ typedef struct {
     uint16_t col_pins[KEYPAD_COLS];
 } keypad_handle_t;
 
+typedef enum {
+    KEYPAD_EVENT_PRESS,
+    KEYPAD_EVENT_RELEASE,
+    KEYPAD_EVENT_LONG_PRESS,
+    KEYPAD_EVENT_REPEAT
+} keypad_event_type_t;
+
+typedef struct {
+    char key;
+    keypad_event_type_t type;
+    uint32_t edge_time;     // HAL_GetTick() del flanco: la EXTI o la primera lectura del cambio
+    uint32_t time;          // HAL_GetTick() al confirmarse tras el antirrebote
+} keypad_event_t;
+
+// Contadores de la cola de eventos: encolados, perdidos por cola llena y máxima ocupación
+typedef record_queue_stats_t keypad_queue_stats_t;
+
 void keypad_init(keypad_handle_t* keypad);
-char keypad_scan(keypad_handle_t* keypad, uint16_t col_pin);
+void keypad_irq(keypad_handle_t* keypad, uint16_t col_pin);
+void keypad_tick(keypad_handle_t* keypad);
+uint8_t keypad_get_events(keypad_event_t* out, uint8_t max);
+void keypad_get_queue_stats(keypad_queue_stats_t* stats);
+bool keypad_is_scanning(void);
+uint16_t keypad_get_keys(void);
 
-#endif // KEYPAD_DRIVER_H
\ No newline at end of file
+#endif // KEYPAD_DRIVER_H
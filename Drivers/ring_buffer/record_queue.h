@@ -0,0 +1,122 @@
+#ifndef RECORD_QUEUE_H
+#define RECORD_QUEUE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*
+ * Fixed-size record queue generated for one element type.
+ *
+ *   RECORD_QUEUE_DEFINE(sample_queue, sample_t, 16, RECORD_QUEUE_REJECT_NEW)
+ *
+ * defines sample_queue_t and static inline sample_queue_init/push/pop/count/
+ * get_stats. The element size is a compile time constant, so a push or pop is
+ * a structure copy (word moves) plus an index update.
+ *
+ * One producer and one consumer (an ISR and the main loop, for instance) may
+ * use a queue concurrently without disabling interrupts. Only the producer
+ * writes head and only the consumer writes tail, both free-running and masked
+ * with the power-of-two capacity.
+ *
+ * Policies when the queue is full:
+ *  - RECORD_QUEUE_REJECT_NEW: the push fails and the new record is dropped.
+ *  - RECORD_QUEUE_OVERWRITE_OLDEST: the push replaces the oldest record. The
+ *    producer still never touches tail: the consumer notices that head got
+ *    more than a capacity ahead, skips what was overwritten and re-checks head
+ *    after each copy, so a record overwritten while being read is discarded.
+ *    This relies on the producer finishing a push before the consumer runs
+ *    again, which holds for an ISR producer; threads on separate cores should
+ *    use RECORD_QUEUE_REJECT_NEW.
+ */
+
+typedef enum {
+    RECORD_QUEUE_REJECT_NEW,
+    RECORD_QUEUE_OVERWRITE_OLDEST
+} record_queue_policy_t;
+
+typedef struct {
+    uint32_t pushed;            // Records accepted
+    uint32_t dropped;           // Records rejected or overwritten before being read
+    uint32_t high_watermark;    // Highest number of records waiting
+} record_queue_stats_t;
+
+#define RECORD_QUEUE_LOAD(p)        __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define RECORD_QUEUE_STORE(p, v)    __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+
+#define RECORD_QUEUE_DEFINE(name, type, capacity, policy)                                   \
+    _Static_assert((capacity) > 0 && ((capacity) & ((capacity) - 1)) == 0,                \
+                   #name ": capacity must be a power of two");                              \
+                                                                                            \
+    typedef struct {                                                                        \
+        type items[capacity];                                                               \
+        uint32_t head;                                                                      \
+        uint32_t tail;                                                                      \
+        record_queue_stats_t stats;                                                         \
+    } name##_t;                                                                             \
+                                                                                            \
+    static inline void name##_init(name##_t *q)                                             \
+    {                                                                                       \
+        q->head = 0;                                                                        \
+        q->tail = 0;                                                                        \
+        q->stats.pushed = 0;                                                                \
+        q->stats.dropped = 0;                                                               \
+        q->stats.high_watermark = 0;                                                        \
+    }                                                                                       \
+                                                                                            \
+    /* Producer side. Returns false when the record was rejected. */                        \
+    static inline bool name##_push(name##_t *q, const type *item)                           \
+    {                                                                                       \
+        uint32_t head = q->head;                                                            \
+        uint32_t used = head - RECORD_QUEUE_LOAD(&q->tail);                                 \
+        if (used >= (capacity)) {                                                           \
+            q->stats.dropped++;                                                             \
+            if ((policy) == RECORD_QUEUE_REJECT_NEW) {                                      \
+                return false;                                                               \
+            }                                                                               \
+            used = (capacity) - 1;                                                          \
+        }                                                                                   \
+        q->items[head & ((capacity) - 1)] = *item;                                          \
+        RECORD_QUEUE_STORE(&q->head, head + 1);                                             \
+        q->stats.pushed++;                                                                  \
+        if (used + 1 > q->stats.high_watermark) {                                           \
+            q->stats.high_watermark = used + 1;                                             \
+        }                                                                                   \
+        return true;                                                                        \
+    }                                                                                       \
+                                                                                            \
+    /* Consumer side. Returns false when the queue is empty. */                             \
+    static inline bool name##_pop(name##_t *q, type *item)                                  \
+    {                                                                                       \
+        uint32_t tail = q->tail;                                                            \
+        for (;;) {                                                                          \
+            uint32_t head = RECORD_QUEUE_LOAD(&q->head);                                    \
+            if (head == tail) {                                                             \
+                RECORD_QUEUE_STORE(&q->tail, tail);                                         \
+                return false;                                                               \
+            }                                                                               \
+            if ((policy) == RECORD_QUEUE_OVERWRITE_OLDEST && head - tail > (capacity)) {    \
+                tail = head - (capacity); /* The oldest ones were overwritten */            \
+            }                                                                               \
+            *item = q->items[tail & ((capacity) - 1)];                                      \
+            if ((policy) == RECORD_QUEUE_OVERWRITE_OLDEST &&                                \
+                RECORD_QUEUE_LOAD(&q->head) - tail > (capacity)) {                          \
+                continue; /* Overwritten during the copy, take the next one */              \
+            }                                                                               \
+            RECORD_QUEUE_STORE(&q->tail, tail + 1);                                         \
+            return true;                                                                    \
+        }                                                                                   \
+    }                                                                                       \
+                                                                                            \
+    static inline uint32_t name##_count(const name##_t *q)                                  \
+    {                                                                                       \
+        uint32_t tail = RECORD_QUEUE_LOAD(&q->tail);                                        \
+        uint32_t used = RECORD_QUEUE_LOAD(&q->head) - tail;                                 \
+        return (used > (capacity)) ? (capacity) : used;                                     \
+    }                                                                                       \
+                                                                                            \
+    static inline void name##_get_stats(const name##_t *q, record_queue_stats_t *stats)     \
+    {                                                                                       \
+        *stats = q->stats;                                                                  \
+    }
+
+#endif // RECORD_QUEUE_H
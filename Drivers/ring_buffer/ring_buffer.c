@@ -1,4 +1,5 @@
 #include "ring_buffer.h"
+#include <string.h>
 
 
 /**
@@ -102,3 +103,268 @@ void ring_buffer_flush(ring_buffer_t *rb)
     rb->tail = 0;
     rb->full = false;
 }
+
+/* Advances an index by len positions, len <= capacity */
+static uint16_t ring_buffer_advance(const ring_buffer_t *rb, uint16_t index, uint16_t len)
+{
+    uint32_t next = (uint32_t)index + len;
+    return (next >= rb->capacity) ? (uint16_t)(next - rb->capacity) : (uint16_t)next;
+}
+
+/**
+ * @brief Returns the contiguous data that starts at the read position.
+ *
+ * @param rb Pointer to the ring buffer.
+ * @param data Set to the first byte to read.
+ * @return The number of bytes in the span, 0 if the buffer is empty.
+ */
+uint16_t ring_buffer_get_read_span(ring_buffer_t *rb, uint8_t **data)
+{
+    *data = &rb->buffer[rb->tail];
+    if (rb->head == rb->tail && !rb->full) {
+        return 0;
+    }
+    return (rb->head > rb->tail) ? rb->head - rb->tail : rb->capacity - rb->tail;
+}
+
+/**
+ * @brief Consumes bytes read through ring_buffer_get_read_span().
+ *
+ * @param rb Pointer to the ring buffer.
+ * @param len Bytes consumed, at most the length of the span.
+ */
+void ring_buffer_commit_read(ring_buffer_t *rb, uint16_t len)
+{
+    if (len == 0) {
+        return;
+    }
+    rb->tail = ring_buffer_advance(rb, rb->tail, len);
+    rb->full = false;
+}
+
+/**
+ * @brief Returns the contiguous free space that starts at the write position,
+ *        for a producer (a DMA transfer for instance) that fills it in place.
+ *
+ * @param rb Pointer to the ring buffer.
+ * @param data Set to the first free byte.
+ * @return The number of bytes in the span, 0 if the buffer is full.
+ */
+uint16_t ring_buffer_get_write_span(ring_buffer_t *rb, uint8_t **data)
+{
+    *data = &rb->buffer[rb->head];
+    if (rb->full) {
+        return 0;
+    }
+    return (rb->tail > rb->head) ? rb->tail - rb->head : rb->capacity - rb->head;
+}
+
+/**
+ * @brief Publishes bytes written through ring_buffer_get_write_span().
+ *
+ * @param rb Pointer to the ring buffer.
+ * @param len Bytes written, at most the length of the span.
+ */
+void ring_buffer_commit_write(ring_buffer_t *rb, uint16_t len)
+{
+    if (len == 0) {
+        return;
+    }
+    rb->head = ring_buffer_advance(rb, rb->head, len);
+    rb->full = (rb->head == rb->tail);
+}
+
+/**
+ * @brief Writes up to len bytes, as many as fit.
+ *
+ * @param rb Pointer to the ring buffer.
+ * @param data Bytes to write.
+ * @param len Number of bytes to write.
+ * @return The number of bytes written.
+ */
+uint16_t ring_buffer_write_n(ring_buffer_t *rb, const uint8_t *data, uint16_t len)
+{
+    uint16_t written = 0;
+    while (written < len) {
+        uint8_t *span;
+        uint16_t n = ring_buffer_get_write_span(rb, &span);
+        if (n == 0) {
+            break;
+        }
+        if (n > len - written) {
+            n = len - written;
+        }
+        memcpy(span, &data[written], n);
+        ring_buffer_commit_write(rb, n);
+        written += n;
+    }
+    return written;
+}
+
+/**
+ * @brief Copies up to len bytes from the read position without consuming them.
+ *
+ * @param rb Pointer to the ring buffer.
+ * @param data Destination of the bytes.
+ * @param len Maximum number of bytes to copy.
+ * @return The number of bytes copied.
+ */
+uint16_t ring_buffer_peek(ring_buffer_t *rb, uint8_t *data, uint16_t len)
+{
+    uint8_t *span;
+    uint16_t count = ring_buffer_count(rb);
+    uint16_t first = ring_buffer_get_read_span(rb, &span);
+
+    if (len > count) {
+        len = count;
+    }
+    if (len <= first) {
+        memcpy(data, span, len);
+    } else {
+        memcpy(data, span, first);
+        memcpy(&data[first], rb->buffer, len - first);
+    }
+    return len;
+}
+
+/**
+ * @brief Reads up to len bytes.
+ *
+ * @param rb Pointer to the ring buffer.
+ * @param data Destination of the bytes.
+ * @param len Maximum number of bytes to read.
+ * @return The number of bytes read.
+ */
+uint16_t ring_buffer_read_n(ring_buffer_t *rb, uint8_t *data, uint16_t len)
+{
+    len = ring_buffer_peek(rb, data, len);
+    ring_buffer_commit_read(rb, len);
+    return len;
+}
+
+/**
+ * @brief Discards up to len bytes from the read position.
+ *
+ * @param rb Pointer to the ring buffer.
+ * @param len Maximum number of bytes to discard.
+ * @return The number of bytes discarded.
+ */
+uint16_t ring_buffer_skip(ring_buffer_t *rb, uint16_t len)
+{
+    uint16_t count = ring_buffer_count(rb);
+    if (len > count) {
+        len = count;
+    }
+    ring_buffer_commit_read(rb, len);
+    return len;
+}
+
+/*
+ * SPSC variant. Each index has a single writer: the producer publishes a byte
+ * with a release store of head after writing it, the consumer frees a slot with
+ * a release store of tail after reading it. The matching acquire loads keep the
+ * data accesses on the right side of the index update. On the Cortex-M4 these
+ * become DMB instructions, on the host they also order the accesses between cores.
+ */
+#define SPSC_LOAD(p)        __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define SPSC_STORE(p, v)    __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+#define SPSC_OWN(p)         __atomic_load_n((p), __ATOMIC_RELAXED)
+
+/**
+ * @brief Initializes an SPSC ring buffer.
+ *
+ * @param rb Pointer to the ring buffer.
+ * @param buffer Backing storage of capacity bytes.
+ * @param capacity Size of the buffer, a power of two.
+ * @return false if the capacity is not a power of two.
+ */
+bool ring_buffer_spsc_init(ring_buffer_spsc_t *rb, uint8_t *buffer, uint32_t capacity)
+{
+    if (capacity == 0 || (capacity & (capacity - 1)) != 0) {
+        return false;
+    }
+    rb->buffer = buffer;
+    rb->mask = capacity - 1;
+    rb->head = 0;
+    rb->tail = 0;
+    return true;
+}
+
+/**
+ * @brief Writes a byte. Producer side only.
+ *
+ * @param rb Pointer to the ring buffer.
+ * @param data The byte of data to write.
+ * @return true if the write was successful, false if the buffer is full.
+ */
+bool ring_buffer_spsc_write(ring_buffer_spsc_t *rb, uint8_t data)
+{
+    uint32_t head = SPSC_OWN(&rb->head);
+    if (head - SPSC_LOAD(&rb->tail) > rb->mask) {
+        return false;
+    }
+    rb->buffer[head & rb->mask] = data;
+    SPSC_STORE(&rb->head, head + 1);
+    return true;
+}
+
+/**
+ * @brief Reads a byte. Consumer side only.
+ *
+ * @param rb Pointer to the ring buffer.
+ * @param data Pointer to where the read data will be stored.
+ * @return true if the read was successful, false if the buffer is empty.
+ */
+bool ring_buffer_spsc_read(ring_buffer_spsc_t *rb, uint8_t *data)
+{
+    uint32_t tail = SPSC_OWN(&rb->tail);
+    if (tail == SPSC_LOAD(&rb->head)) {
+        return false;
+    }
+    *data = rb->buffer[tail & rb->mask];
+    SPSC_STORE(&rb->tail, tail + 1);
+    return true;
+}
+
+/**
+ * @brief Returns the number of bytes in the buffer. Exact from either side
+ *        for its own index, a snapshot for the other one.
+ *
+ * @param rb Pointer to the ring buffer.
+ * @return The number of bytes in the buffer.
+ */
+uint32_t ring_buffer_spsc_count(const ring_buffer_spsc_t *rb)
+{
+    uint32_t tail = SPSC_LOAD(&rb->tail);
+    return SPSC_LOAD(&rb->head) - tail;
+}
+
+/**
+ * @brief Checks if the buffer is empty. Exact from the consumer side.
+ *
+ * @param rb Pointer to the ring buffer.
+ * @return true if the buffer is empty, false otherwise.
+ */
+bool ring_buffer_spsc_is_empty(const ring_buffer_spsc_t *rb)
+{
+    return ring_buffer_spsc_count(rb) == 0;
+}
+
+/**
+ * @brief Checks if the buffer is full. Exact from the producer side.
+ *
+ * @param rb Pointer to the ring buffer.
+ * @return true if the buffer is full, false otherwise.
+ */
+bool ring_buffer_spsc_is_full(const ring_buffer_spsc_t *rb)
+{
+    return ring_buffer_spsc_count(rb) > rb->mask;
+}
+
+/**
+ * @brief Discards the pending bytes. Consumer side only.
+ */
+void ring_buffer_spsc_flush(ring_buffer_spsc_t *rb)
+{
+    SPSC_STORE(&rb->tail, SPSC_LOAD(&rb->head));
+}
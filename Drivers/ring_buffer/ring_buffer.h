@@ -20,4 +20,42 @@ bool ring_buffer_is_empty(ring_buffer_t *rb);
 bool ring_buffer_is_full(ring_buffer_t *rb);
 void ring_buffer_flush(ring_buffer_t *rb);
 
+/*
+ * Bulk and zero-copy access. Unlike ring_buffer_write(), these never overwrite
+ * unread data: they move as much as fits and return how much that was.
+ * A span is the contiguous part of the data (or of the free space) that starts
+ * at the read (or write) position; the rest wraps to the start of the buffer
+ * and comes in the next span once the first one is committed.
+ */
+uint16_t ring_buffer_write_n(ring_buffer_t *rb, const uint8_t *data, uint16_t len);
+uint16_t ring_buffer_read_n(ring_buffer_t *rb, uint8_t *data, uint16_t len);
+uint16_t ring_buffer_peek(ring_buffer_t *rb, uint8_t *data, uint16_t len);
+uint16_t ring_buffer_skip(ring_buffer_t *rb, uint16_t len);
+uint16_t ring_buffer_get_read_span(ring_buffer_t *rb, uint8_t **data);
+void ring_buffer_commit_read(ring_buffer_t *rb, uint16_t len);
+uint16_t ring_buffer_get_write_span(ring_buffer_t *rb, uint8_t **data);
+void ring_buffer_commit_write(ring_buffer_t *rb, uint16_t len);
+
+/*
+ * Single-producer/single-consumer variant, safe between one ISR and the main
+ * loop (or two threads) without disabling interrupts. The capacity must be a
+ * power of two: head and tail run freely and are masked on access, so the
+ * producer only writes head and the consumer only writes tail.
+ * When full, writes are rejected instead of overwriting the oldest byte.
+ */
+typedef struct {
+    uint8_t *buffer;
+    uint32_t head;      // Written by the producer only
+    uint32_t tail;      // Written by the consumer only
+    uint32_t mask;      // capacity - 1
+} ring_buffer_spsc_t;
+
+bool ring_buffer_spsc_init(ring_buffer_spsc_t *rb, uint8_t *buffer, uint32_t capacity);
+bool ring_buffer_spsc_write(ring_buffer_spsc_t *rb, uint8_t data);
+bool ring_buffer_spsc_read(ring_buffer_spsc_t *rb, uint8_t *data);
+uint32_t ring_buffer_spsc_count(const ring_buffer_spsc_t *rb);
+bool ring_buffer_spsc_is_empty(const ring_buffer_spsc_t *rb);
+bool ring_buffer_spsc_is_full(const ring_buffer_spsc_t *rb);
+void ring_buffer_spsc_flush(ring_buffer_spsc_t *rb);
+
 #endif // RING_BUFFER_H
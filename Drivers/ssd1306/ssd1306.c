@@ -3,25 +3,50 @@
 #include <stdlib.h>
 #include <string.h>  // For memcpy
 
-#if defined(SSD1306_USE_I2C)
+// Flush and bus counters, updated by the transport wrappers below
+static SSD1306_FlushStats_t SSD1306_Stats;
 
-void ssd1306_Reset(void) {
+#if defined(SSD1306_HOST)
+
+// Transports of the host build live in ssd1306_host.c
+
+#elif defined(SSD1306_USE_I2C)
+
+static void ssd1306_I2C_Begin(void) {
     /* for I2C - do nothing */
 }
 
-// Send a byte to the command register
-void ssd1306_WriteCommand(uint8_t byte) {
-    HAL_I2C_Mem_Write(&SSD1306_I2C_PORT, SSD1306_I2C_ADDR, 0x00, 1, &byte, 1, HAL_MAX_DELAY);
+// A single 0x00 control byte covers the whole batch
+static void ssd1306_I2C_WriteCommands(const uint8_t* cmds, size_t count) {
+    HAL_I2C_Mem_Write(&SSD1306_I2C_PORT, SSD1306_I2C_ADDR, 0x00, 1, (uint8_t*)cmds, count, HAL_MAX_DELAY);
 }
 
-// Send data
-void ssd1306_WriteData(uint8_t* buffer, size_t buff_size) {
-    HAL_I2C_Mem_Write(&SSD1306_I2C_PORT, SSD1306_I2C_ADDR, 0x40, 1, buffer, buff_size, HAL_MAX_DELAY);
+static void ssd1306_I2C_WriteData(const uint8_t* data, size_t count) {
+    HAL_I2C_Mem_Write(&SSD1306_I2C_PORT, SSD1306_I2C_ADDR, 0x40, 1, (uint8_t*)data, count, HAL_MAX_DELAY);
 }
 
+// Data goes through DMA, the few window command bytes through the interrupt driven transfer
+static SSD1306_Error_t ssd1306_I2C_WriteAsync(uint8_t is_data, const uint8_t* buffer, size_t count) {
+    HAL_StatusTypeDef status;
+    if (is_data) {
+        status = HAL_I2C_Mem_Write_DMA(&SSD1306_I2C_PORT, SSD1306_I2C_ADDR, 0x40, 1, (uint8_t*)buffer, count);
+    } else {
+        status = HAL_I2C_Mem_Write_IT(&SSD1306_I2C_PORT, SSD1306_I2C_ADDR, 0x00, 1, (uint8_t*)buffer, count);
+    }
+    return (status == HAL_OK) ? SSD1306_OK : SSD1306_ERR;
+}
+
+const SSD1306_Transport_t SSD1306_TransportI2C = {
+    ssd1306_I2C_Begin, ssd1306_I2C_WriteCommands, ssd1306_I2C_WriteData, NULL, NULL
+};
+
+const SSD1306_Transport_t SSD1306_TransportI2C_DMA = {
+    ssd1306_I2C_Begin, ssd1306_I2C_WriteCommands, ssd1306_I2C_WriteData, ssd1306_I2C_WriteAsync, NULL
+};
+
 #elif defined(SSD1306_USE_SPI)
 
-void ssd1306_Reset(void) {
+static void ssd1306_SPI_Begin(void) {
     // CS = High (not selected)
     HAL_GPIO_WritePin(SSD1306_CS_Port, SSD1306_CS_Pin, GPIO_PIN_SET);
 
@@ -32,136 +57,391 @@ void ssd1306_Reset(void) {
     HAL_Delay(10);
 }
 
-// Send a byte to the command register
-void ssd1306_WriteCommand(uint8_t byte) {
+// Send a sequence of commands with a single chip select
+static void ssd1306_SPI_WriteCommands(const uint8_t* cmds, size_t count) {
     HAL_GPIO_WritePin(SSD1306_CS_Port, SSD1306_CS_Pin, GPIO_PIN_RESET); // select OLED
     HAL_GPIO_WritePin(SSD1306_DC_Port, SSD1306_DC_Pin, GPIO_PIN_RESET); // command
-    HAL_SPI_Transmit(&SSD1306_SPI_PORT, (uint8_t *) &byte, 1, HAL_MAX_DELAY);
+    HAL_SPI_Transmit(&SSD1306_SPI_PORT, (uint8_t *) cmds, count, HAL_MAX_DELAY);
     HAL_GPIO_WritePin(SSD1306_CS_Port, SSD1306_CS_Pin, GPIO_PIN_SET); // un-select OLED
 }
 
-// Send data
-void ssd1306_WriteData(uint8_t* buffer, size_t buff_size) {
+static void ssd1306_SPI_WriteData(const uint8_t* data, size_t count) {
     HAL_GPIO_WritePin(SSD1306_CS_Port, SSD1306_CS_Pin, GPIO_PIN_RESET); // select OLED
     HAL_GPIO_WritePin(SSD1306_DC_Port, SSD1306_DC_Pin, GPIO_PIN_SET); // data
-    HAL_SPI_Transmit(&SSD1306_SPI_PORT, buffer, buff_size, HAL_MAX_DELAY);
+    HAL_SPI_Transmit(&SSD1306_SPI_PORT, (uint8_t *) data, count, HAL_MAX_DELAY);
     HAL_GPIO_WritePin(SSD1306_CS_Port, SSD1306_CS_Pin, GPIO_PIN_SET); // un-select OLED
 }
 
+// The chip select stays low until ssd1306_SPI_Complete()
+static SSD1306_Error_t ssd1306_SPI_WriteAsync(uint8_t is_data, const uint8_t* buffer, size_t count) {
+    HAL_StatusTypeDef status;
+    HAL_GPIO_WritePin(SSD1306_CS_Port, SSD1306_CS_Pin, GPIO_PIN_RESET); // select OLED
+    if (is_data) {
+        HAL_GPIO_WritePin(SSD1306_DC_Port, SSD1306_DC_Pin, GPIO_PIN_SET); // data
+        status = HAL_SPI_Transmit_DMA(&SSD1306_SPI_PORT, (uint8_t *) buffer, count);
+    } else {
+        HAL_GPIO_WritePin(SSD1306_DC_Port, SSD1306_DC_Pin, GPIO_PIN_RESET); // command
+        status = HAL_SPI_Transmit_IT(&SSD1306_SPI_PORT, (uint8_t *) buffer, count);
+    }
+    return (status == HAL_OK) ? SSD1306_OK : SSD1306_ERR;
+}
+
+static void ssd1306_SPI_Complete(void) {
+    HAL_GPIO_WritePin(SSD1306_CS_Port, SSD1306_CS_Pin, GPIO_PIN_SET); // un-select OLED
+}
+
+const SSD1306_Transport_t SSD1306_TransportSPI = {
+    ssd1306_SPI_Begin, ssd1306_SPI_WriteCommands, ssd1306_SPI_WriteData, NULL, NULL
+};
+
+const SSD1306_Transport_t SSD1306_TransportSPI_DMA = {
+    ssd1306_SPI_Begin, ssd1306_SPI_WriteCommands, ssd1306_SPI_WriteData, ssd1306_SPI_WriteAsync, ssd1306_SPI_Complete
+};
+
 #else
 #error "You should define SSD1306_USE_SPI or SSD1306_USE_I2C macro"
 #endif
 
+// Transport used by ssd1306_Init(), ssd1306_InitTransport() picks another one
+#if defined(SSD1306_HOST)
+#define SSD1306_DEFAULT_TRANSPORT   SSD1306_TransportHost
+#elif defined(SSD1306_USE_I2C) && defined(SSD1306_USE_DMA)
+#define SSD1306_DEFAULT_TRANSPORT   SSD1306_TransportI2C_DMA
+#elif defined(SSD1306_USE_I2C)
+#define SSD1306_DEFAULT_TRANSPORT   SSD1306_TransportI2C
+#elif defined(SSD1306_USE_DMA)
+#define SSD1306_DEFAULT_TRANSPORT   SSD1306_TransportSPI_DMA
+#else
+#define SSD1306_DEFAULT_TRANSPORT   SSD1306_TransportSPI
+#endif
+
+static const SSD1306_Transport_t* SSD1306_Transport = &SSD1306_DEFAULT_TRANSPORT;
+
+void ssd1306_Reset(void) {
+    SSD1306_Transport->Begin();
+}
+
+// Send a byte to the command register
+void ssd1306_WriteCommand(uint8_t byte) {
+    ssd1306_WriteCommands(&byte, 1);
+}
+
+// Send a sequence of commands in one transaction
+void ssd1306_WriteCommands(const uint8_t* cmds, size_t count) {
+    ssd1306_WaitForFlush(HAL_MAX_DELAY);
+    SSD1306_Transport->WriteCommands(cmds, count);
+    SSD1306_Stats.Transactions++;
+}
+
+// Send data
+void ssd1306_WriteData(uint8_t* buffer, size_t buff_size) {
+    ssd1306_WaitForFlush(HAL_MAX_DELAY);
+    SSD1306_Transport->WriteData(buffer, buff_size);
+    SSD1306_Stats.Transactions++;
+}
 
-// Screenbuffer
+// Start a non-blocking transfer, completion is reported through ssd1306_FlushCpltCallback()
+static SSD1306_Error_t ssd1306_WriteAsync(uint8_t is_data, uint8_t* buffer, size_t buff_size) {
+    SSD1306_Stats.Transactions++;
+    return SSD1306_Transport->WriteAsync(is_data, buffer, buff_size);
+}
+
+static void ssd1306_WriteAsyncDone(void) {
+    if (SSD1306_Transport->Complete != NULL) {
+        SSD1306_Transport->Complete();
+    }
+}
+
+
+// Column offset of the first visible pixel in controller RAM
+#define SSD1306_X_OFFSET_COLUMN ((SSD1306_X_OFFSET_UPPER << 4) | SSD1306_X_OFFSET_LOWER)
+
+// Unchanged bytes worth bridging instead of opening a new span.
+// Roughly the cost of the window commands that a new span needs.
+#define SSD1306_SPAN_MERGE_GAP  8
+
+// Spans a single page may be split into before the rest of it is sent in one go
+#define SSD1306_SPANS_PER_PAGE  4
+#define SSD1306_MAX_SPANS       (SSD1306_PAGES * SSD1306_SPANS_PER_PAGE)
+
+// Page addressing cannot open a window wider than one page, so no burst
+#if defined(SSD1306_FULL_FRAME_BURST) && !defined(SSD1306_PAGE_MODE)
+#define SSD1306_USE_BURST
+#endif
+
+// A run of changed bytes. It covers a single page, except for the
+// full-frame burst which spans all pages at full width.
+typedef struct {
+    uint8_t page;
+    uint8_t page2;
+    uint8_t x1;
+    uint8_t x2;
+} SSD1306_Span_t;
+
+// Screenbuffer (back buffer), all drawing goes here
 static uint8_t SSD1306_Buffer[SSD1306_BUFFER_SIZE];
 
+// Front buffer: what the panel shows once the current flush has completed.
+// Flushes transmit from here, so drawing the next frame can overlap a DMA transfer.
+static uint8_t SSD1306_Panel[SSD1306_BUFFER_SIZE];
+static volatile uint8_t SSD1306_PanelValid = 0;   // Cleared by a failed flush, from its interrupt
+
+// Spans of the flush being transmitted
+static SSD1306_Span_t SSD1306_Spans[SSD1306_MAX_SPANS];
+static uint8_t SSD1306_SpanCount = 0;
+
+// State of the asynchronous flush
+static volatile uint8_t SSD1306_FlushBusy = 0;
+static uint8_t SSD1306_SpanIndex = 0;
+static uint8_t SSD1306_SpanPhase = 0;      // 0: window commands, 1: data
+static uint8_t SSD1306_WindowCmd[6];
+
+// Dirty column range per page, empty when DirtyX1 > DirtyX2
+static uint8_t SSD1306_DirtyX1[SSD1306_PAGES];
+static uint8_t SSD1306_DirtyX2[SSD1306_PAGES];
+
 // Screen object
 static SSD1306_t SSD1306;
 
+/* Add a clipped rectangle to the dirty ranges, corners in any order */
+static void ssd1306_MarkDirty(int32_t x1, int32_t y1, int32_t x2, int32_t y2) {
+    if (x1 > x2) { int32_t t = x1; x1 = x2; x2 = t; }
+    if (y1 > y2) { int32_t t = y1; y1 = y2; y2 = t; }
+    if (x2 < 0 || y2 < 0 || x1 >= SSD1306_WIDTH || y1 >= SSD1306_HEIGHT) {
+        return;
+    }
+    if (x1 < 0) x1 = 0;
+    if (y1 < 0) y1 = 0;
+    if (x2 >= SSD1306_WIDTH) x2 = SSD1306_WIDTH - 1;
+    if (y2 >= SSD1306_HEIGHT) y2 = SSD1306_HEIGHT - 1;
+
+    for (int32_t page = y1 / 8; page <= y2 / 8; page++) {
+        if (x1 < SSD1306_DirtyX1[page]) SSD1306_DirtyX1[page] = x1;
+        if (x2 > SSD1306_DirtyX2[page]) SSD1306_DirtyX2[page] = x2;
+    }
+}
+
+/* Draw one pixel without touching the dirty ranges, caller marks them */
+static inline void ssd1306_DrawPixelRaw(uint8_t x, uint8_t y, SSD1306_COLOR color) {
+    if(x >= SSD1306_WIDTH || y >= SSD1306_HEIGHT) {
+        return;
+    }
+
+    if(color == White) {
+        SSD1306_Buffer[x + (y / 8) * SSD1306_WIDTH] |= 1 << (y % 8);
+    } else {
+        SSD1306_Buffer[x + (y / 8) * SSD1306_WIDTH] &= ~(1 << (y % 8));
+    }
+}
+
+/*
+ * Fill a clipped rectangle a byte at a time, corners in order, caller marks it dirty.
+ * Each page gets one mask for the rows it covers, so horizontal runs, vertical runs
+ * and boxes cost one read-modify-write per column and page instead of per pixel.
+ */
+static void ssd1306_FillSpanRaw(int32_t x1, int32_t y1, int32_t x2, int32_t y2, SSD1306_COLOR color) {
+    if (x2 < 0 || y2 < 0 || x1 >= SSD1306_WIDTH || y1 >= SSD1306_HEIGHT || x1 > x2 || y1 > y2) {
+        return;
+    }
+    if (x1 < 0) x1 = 0;
+    if (y1 < 0) y1 = 0;
+    if (x2 >= SSD1306_WIDTH) x2 = SSD1306_WIDTH - 1;
+    if (y2 >= SSD1306_HEIGHT) y2 = SSD1306_HEIGHT - 1;
+
+    for (int32_t page = y1 / 8; page <= y2 / 8; page++) {
+        uint8_t mask = 0xFF;
+        if (page == y1 / 8) mask &= 0xFF << (y1 % 8);
+        if (page == y2 / 8) mask &= 0xFF >> (7 - (y2 % 8));
+
+        uint8_t *buf = &SSD1306_Buffer[SSD1306_WIDTH * page + x1];
+        uint8_t *end = &SSD1306_Buffer[SSD1306_WIDTH * page + x2];
+        if (mask == 0xFF) {
+            memset(buf, (color == White) ? 0xFF : 0x00, end - buf + 1);
+        } else if (color == White) {
+            for (; buf <= end; buf++) *buf |= mask;
+        } else {
+            mask = ~mask;
+            for (; buf <= end; buf++) *buf &= mask;
+        }
+    }
+}
+
+/*
+ * Build the commands restricting the controller write window to the given columns and pages.
+ * cmd must hold 6 bytes, returns the number of bytes used.
+ */
+static uint8_t ssd1306_BuildWindow(uint8_t* cmd, uint8_t x1, uint8_t x2, uint8_t page1, uint8_t page2) {
+#ifdef SSD1306_PAGE_MODE
+    // Page addressing: only the start is set, data wraps inside the page
+    (void)x2;
+    (void)page2;
+    cmd[0] = 0xB0 + page1; // Set the current RAM page address
+    cmd[1] = 0x00 + ((SSD1306_X_OFFSET_COLUMN + x1) & 0x0F);
+    cmd[2] = 0x10 + ((SSD1306_X_OFFSET_COLUMN + x1) >> 4);
+    return 3;
+#else
+    cmd[0] = 0x21; // Set column address
+    cmd[1] = SSD1306_X_OFFSET_COLUMN + x1;
+    cmd[2] = SSD1306_X_OFFSET_COLUMN + x2;
+    cmd[3] = 0x22; // Set page address
+    cmd[4] = page1;
+    cmd[5] = page2;
+    return 6;
+#endif
+}
+
+/* Restrict the controller write window to the given columns and pages */
+static void ssd1306_SetWindow(uint8_t x1, uint8_t x2, uint8_t page1, uint8_t page2) {
+    uint8_t cmd[6];
+    ssd1306_WriteCommands(cmd, ssd1306_BuildWindow(cmd, x1, x2, page1, page2));
+}
+
+/* First byte and length of the front buffer data covered by a span */
+static inline uint8_t* ssd1306_SpanData(const SSD1306_Span_t *span) {
+    return &SSD1306_Panel[SSD1306_WIDTH * span->page + span->x1];
+}
+
+static inline uint32_t ssd1306_SpanLength(const SSD1306_Span_t *span) {
+    return (uint32_t)(span->x2 - span->x1 + 1) * (span->page2 - span->page + 1);
+}
+
 /* Fills the Screenbuffer with values from a given buffer of a fixed length */
 SSD1306_Error_t ssd1306_FillBuffer(uint8_t* buf, uint32_t len) {
     SSD1306_Error_t ret = SSD1306_ERR;
     if (len <= SSD1306_BUFFER_SIZE) {
         memcpy(SSD1306_Buffer,buf,len);
+        ssd1306_MarkDirty(0, 0, SSD1306_WIDTH - 1, SSD1306_HEIGHT - 1);
         ret = SSD1306_OK;
     }
     return ret;
 }
 
-/* Initialize the oled screen */
-void ssd1306_Init(void) {
-    // Reset OLED
-    ssd1306_Reset();
-
-    // Wait for the screen to boot
-    HAL_Delay(100);
+/*
+ * Replace the screenbuffer with a prebuilt frame in page layout (see tools/screen_pack.py).
+ * Only the columns that differ from the current screenbuffer become dirty, so reloading
+ * the same screen and redrawing its dynamic fields sends just what changed.
+ */
+void ssd1306_LoadScreen(const uint8_t* screen) {
+    for (uint8_t page = 0; page < SSD1306_PAGES; page++) {
+        uint8_t *buf = &SSD1306_Buffer[SSD1306_WIDTH * page];
+        const uint8_t *src = &screen[SSD1306_WIDTH * page];
+        int32_t x1 = 0;
+        int32_t x2 = SSD1306_WIDTH - 1;
+
+        while (x1 <= x2 && buf[x1] == src[x1]) x1++;
+        while (x2 >= x1 && buf[x2] == src[x2]) x2--;
+        if (x1 > x2) {
+            continue;
+        }
+        memcpy(&buf[x1], &src[x1], x2 - x1 + 1);
+        ssd1306_MarkDirty(x1, page * 8, x2, page * 8 + 7);
+    }
+}
 
-    // Init OLED
-    ssd1306_SetDisplayOn(0); //display off
+/* Power-up command sequence, sent as one batch by ssd1306_Init() */
+static const uint8_t ssd1306_InitSequence[] = {
+    0xAE, //display off
 
-    ssd1306_WriteCommand(0x20); //Set Memory Addressing Mode
-    ssd1306_WriteCommand(0x00); // 00b,Horizontal Addressing Mode; 01b,Vertical Addressing Mode;
-                                // 10b,Page Addressing Mode (RESET); 11b,Invalid
+    0x20, //Set Memory Addressing Mode
+#ifdef SSD1306_PAGE_MODE
+    0x02, // 00b,Horizontal Addressing Mode; 01b,Vertical Addressing Mode;
+#else
+    0x00, // 00b,Horizontal Addressing Mode; 01b,Vertical Addressing Mode;
+#endif
+          // 10b,Page Addressing Mode (RESET); 11b,Invalid
 
-    ssd1306_WriteCommand(0xB0); //Set Page Start Address for Page Addressing Mode,0-7
+    0xB0, //Set Page Start Address for Page Addressing Mode,0-7
 
 #ifdef SSD1306_MIRROR_VERT
-    ssd1306_WriteCommand(0xC0); // Mirror vertically
+    0xC0, // Mirror vertically
 #else
-    ssd1306_WriteCommand(0xC8); //Set COM Output Scan Direction
+    0xC8, //Set COM Output Scan Direction
 #endif
 
-    ssd1306_WriteCommand(0x00); //---set low column address
-    ssd1306_WriteCommand(0x10); //---set high column address
+    0x00, //---set low column address
+    0x10, //---set high column address
 
-    ssd1306_WriteCommand(0x40); //--set start line address - CHECK
+    0x40, //--set start line address - CHECK
 
-    ssd1306_SetContrast(0xFF);
+    0x81, 0xFF, //--set contrast control register
 
 #ifdef SSD1306_MIRROR_HORIZ
-    ssd1306_WriteCommand(0xA0); // Mirror horizontally
+    0xA0, // Mirror horizontally
 #else
-    ssd1306_WriteCommand(0xA1); //--set segment re-map 0 to 127 - CHECK
+    0xA1, //--set segment re-map 0 to 127 - CHECK
 #endif
 
 #ifdef SSD1306_INVERSE_COLOR
-    ssd1306_WriteCommand(0xA7); //--set inverse color
+    0xA7, //--set inverse color
 #else
-    ssd1306_WriteCommand(0xA6); //--set normal color
+    0xA6, //--set normal color
 #endif
 
 // Set multiplex ratio.
 #if (SSD1306_HEIGHT == 128)
     // Found in the Luma Python lib for SH1106.
-    ssd1306_WriteCommand(0xFF);
+    0xFF,
 #else
-    ssd1306_WriteCommand(0xA8); //--set multiplex ratio(1 to 64) - CHECK
+    0xA8, //--set multiplex ratio(1 to 64) - CHECK
 #endif
 
 #if (SSD1306_HEIGHT == 32)
-    ssd1306_WriteCommand(0x1F); //
+    0x1F, //
 #elif (SSD1306_HEIGHT == 64)
-    ssd1306_WriteCommand(0x3F); //
+    0x3F, //
 #elif (SSD1306_HEIGHT == 128)
-    ssd1306_WriteCommand(0x3F); // Seems to work for 128px high displays too.
+    0x3F, // Seems to work for 128px high displays too.
 #else
 #error "Only 32, 64, or 128 lines of height are supported!"
 #endif
 
-    ssd1306_WriteCommand(0xA4); //0xa4,Output follows RAM content;0xa5,Output ignores RAM content
+    0xA4, //0xa4,Output follows RAM content;0xa5,Output ignores RAM content
 
-    ssd1306_WriteCommand(0xD3); //-set display offset - CHECK
-    ssd1306_WriteCommand(0x00); //-not offset
+    0xD3, //-set display offset - CHECK
+    0x00, //-not offset
 
-    ssd1306_WriteCommand(0xD5); //--set display clock divide ratio/oscillator frequency
-    ssd1306_WriteCommand(0xF0); //--set divide ratio
+    0xD5, //--set display clock divide ratio/oscillator frequency
+    0xF0, //--set divide ratio
 
-    ssd1306_WriteCommand(0xD9); //--set pre-charge period
-    ssd1306_WriteCommand(0x22); //
+    0xD9, //--set pre-charge period
+    0x22, //
 
-    ssd1306_WriteCommand(0xDA); //--set com pins hardware configuration - CHECK
+    0xDA, //--set com pins hardware configuration - CHECK
 #if (SSD1306_HEIGHT == 32)
-    ssd1306_WriteCommand(0x02);
+    0x02,
 #elif (SSD1306_HEIGHT == 64)
-    ssd1306_WriteCommand(0x12);
+    0x12,
 #elif (SSD1306_HEIGHT == 128)
-    ssd1306_WriteCommand(0x12);
+    0x12,
 #else
 #error "Only 32, 64, or 128 lines of height are supported!"
 #endif
 
-    ssd1306_WriteCommand(0xDB); //--set vcomh
-    ssd1306_WriteCommand(0x20); //0x20,0.77xVcc
+    0xDB, //--set vcomh
+    0x20, //0x20,0.77xVcc
 
-    ssd1306_WriteCommand(0x8D); //--set DC-DC enable
-    ssd1306_WriteCommand(0x14); //
-    ssd1306_SetDisplayOn(1); //--turn on SSD1306 panel
+    0x8D, //--set DC-DC enable
+    0x14, //
+    0xAF, //--turn on SSD1306 panel
+};
+
+/* Initialize the oled screen */
+void ssd1306_Init(void) {
+    // Reset OLED
+    ssd1306_Reset();
+
+    // Wait for the screen to boot
+    HAL_Delay(100);
+
+    // Init OLED, the whole sequence goes out in one transaction
+    ssd1306_WriteCommands(ssd1306_InitSequence, sizeof(ssd1306_InitSequence));
+    SSD1306.DisplayOn = 1;
 
     // Clear screen
     ssd1306_Fill(Black);
     
-    // Flush buffer to screen
+    // Flush buffer to screen, the panel RAM content is unknown after reset
+    ssd1306_InvalidateScreen();
     ssd1306_UpdateScreen();
     
     // Set default values for screen object
@@ -171,25 +451,275 @@ void ssd1306_Init(void) {
     SSD1306.Initialized = 1;
 }
 
+void ssd1306_InitTransport(const SSD1306_Transport_t* transport) {
+    // Let a transfer on the previous transport finish first
+    ssd1306_WaitForFlush(HAL_MAX_DELAY);
+    SSD1306_Transport = transport;
+    ssd1306_Init();
+}
+
 /* Fill the whole screen with the given color */
 void ssd1306_Fill(SSD1306_COLOR color) {
     memset(SSD1306_Buffer, (color == Black) ? 0x00 : 0xFF, sizeof(SSD1306_Buffer));
+    ssd1306_MarkDirty(0, 0, SSD1306_WIDTH - 1, SSD1306_HEIGHT - 1);
+}
+
+/* Account one flush that sent the given number of data bytes */
+static void ssd1306_CountFlush(uint32_t sent) {
+    SSD1306_Stats.Flushes++;
+    SSD1306_Stats.LastBytesSent = sent;
+    SSD1306_Stats.LastBytesSaved = SSD1306_BUFFER_SIZE - sent;
+    SSD1306_Stats.TotalBytesSent += sent;
+    SSD1306_Stats.TotalBytesSaved += SSD1306_BUFFER_SIZE - sent;
+}
+
+/*
+ * Collect the changed spans of the back buffer and copy them into the front buffer.
+ * Only pages touched since the last flush are visited. Within a dirty range,
+ * bytes that already match the panel are skipped; short runs of unchanged
+ * bytes are sent anyway when that is cheaper than a new window.
+ * Returns the number of data bytes to send.
+ */
+static uint32_t ssd1306_CollectSpans(void) {
+    uint32_t sent = 0;
+    SSD1306_SpanCount = 0;
+
+    // A failed flush only clears PanelValid, from its interrupt: the dirty
+    // ranges belong to the main loop, so the whole screen is widened here
+    if (!SSD1306_PanelValid) {
+        for (uint8_t page = 0; page < SSD1306_PAGES; page++) {
+            SSD1306_DirtyX1[page] = 0;
+            SSD1306_DirtyX2[page] = SSD1306_WIDTH - 1;
+        }
+    }
+
+    for(uint8_t page = 0; page < SSD1306_PAGES; page++) {
+        if (SSD1306_DirtyX1[page] > SSD1306_DirtyX2[page]) {
+            continue;
+        }
+
+        uint8_t *buf = &SSD1306_Buffer[SSD1306_WIDTH * page];
+        uint8_t *panel = &SSD1306_Panel[SSD1306_WIDTH * page];
+        uint32_t x = SSD1306_DirtyX1[page];
+        uint32_t x_end = SSD1306_DirtyX2[page];
+        uint8_t page_spans = 0;
+
+        while (x <= x_end) {
+            if (SSD1306_PanelValid && buf[x] == panel[x]) {
+                x++;
+                continue;
+            }
+
+            uint32_t span_start = x;
+            uint32_t span_end = x;
+            if (page_spans == SSD1306_SPANS_PER_PAGE - 1) {
+                // Out of spans for this page, send the rest of the range at once
+                span_end = x_end;
+            } else {
+                for (x = span_start + 1; x <= x_end; x++) {
+                    if (!SSD1306_PanelValid || buf[x] != panel[x]) {
+                        span_end = x;
+                    } else if (x - span_end > SSD1306_SPAN_MERGE_GAP) {
+                        break;
+                    }
+                }
+            }
+
+            uint32_t len = span_end - span_start + 1;
+            memcpy(&panel[span_start], &buf[span_start], len);
+            SSD1306_Spans[SSD1306_SpanCount].page = page;
+            SSD1306_Spans[SSD1306_SpanCount].page2 = page;
+            SSD1306_Spans[SSD1306_SpanCount].x1 = span_start;
+            SSD1306_Spans[SSD1306_SpanCount].x2 = span_end;
+            SSD1306_SpanCount++;
+            page_spans++;
+            sent += len;
+            x = span_end + 1;
+        }
+
+        SSD1306_DirtyX1[page] = SSD1306_WIDTH;
+        SSD1306_DirtyX2[page] = 0;
+    }
+
+    SSD1306_PanelValid = 1;
+
+#ifdef SSD1306_USE_BURST
+    // Every span pays for its window commands. Once that adds up to more than
+    // the unchanged bytes, one window over the whole frame and a single data
+    // transfer is cheaper. Clean pages already match the panel, so after the
+    // copy the front buffer equals the screenbuffer.
+    if (SSD1306_SpanCount > 1 &&
+        sent + SSD1306_SpanCount * SSD1306_SPAN_MERGE_GAP >= SSD1306_BUFFER_SIZE + SSD1306_SPAN_MERGE_GAP) {
+        memcpy(SSD1306_Panel, SSD1306_Buffer, SSD1306_BUFFER_SIZE);
+        SSD1306_Spans[0].page = 0;
+        SSD1306_Spans[0].page2 = SSD1306_PAGES - 1;
+        SSD1306_Spans[0].x1 = 0;
+        SSD1306_Spans[0].x2 = SSD1306_WIDTH - 1;
+        SSD1306_SpanCount = 1;
+        sent = SSD1306_BUFFER_SIZE;
+    }
+#endif
+
+    ssd1306_CountFlush(sent);
+    return sent;
 }
 
-/* Write the screenbuffer with changed to the screen */
+/* Write the changed parts of the screenbuffer to the screen */
 void ssd1306_UpdateScreen(void) {
-    // Write data to each page of RAM. Number of pages
-    // depends on the screen height:
-    //
-    //  * 32px   ==  4 pages
-    //  * 64px   ==  8 pages
-    //  * 128px  ==  16 pages
-    for(uint8_t i = 0; i < SSD1306_HEIGHT/8; i++) {
-        ssd1306_WriteCommand(0xB0 + i); // Set the current RAM page address.
-        ssd1306_WriteCommand(0x00 + SSD1306_X_OFFSET_LOWER);
-        ssd1306_WriteCommand(0x10 + SSD1306_X_OFFSET_UPPER);
-        ssd1306_WriteData(&SSD1306_Buffer[SSD1306_WIDTH*i],SSD1306_WIDTH);
+    // The front buffer may still be on its way to the panel
+    ssd1306_WaitForFlush(HAL_MAX_DELAY);
+
+    ssd1306_CollectSpans();
+    for (uint8_t i = 0; i < SSD1306_SpanCount; i++) {
+        const SSD1306_Span_t *span = &SSD1306_Spans[i];
+        ssd1306_SetWindow(span->x1, span->x2, span->page, span->page2);
+        ssd1306_WriteData(ssd1306_SpanData(span), ssd1306_SpanLength(span));
+    }
+}
+
+/*
+ * Write one rectangle of the screenbuffer to the screen, whatever the dirty ranges say.
+ * Horizontal addressing opens a single window and streams it page by page, the
+ * controller wraps to the next page at the right edge. Page addressing needs
+ * a window per page.
+ */
+SSD1306_Error_t ssd1306_UpdateRegion(uint8_t x, uint8_t y, uint8_t w, uint8_t h) {
+    if (w == 0 || h == 0 || x >= SSD1306_WIDTH || y >= SSD1306_HEIGHT) {
+        return SSD1306_ERR;
+    }
+
+    uint32_t x2 = (uint32_t)x + w - 1;
+    uint32_t y2 = (uint32_t)y + h - 1;
+    if (x2 >= SSD1306_WIDTH) x2 = SSD1306_WIDTH - 1;
+    if (y2 >= SSD1306_HEIGHT) y2 = SSD1306_HEIGHT - 1;
+
+    uint8_t page1 = y / 8;
+    uint8_t page2 = y2 / 8;
+    uint32_t len = x2 - x + 1;
+
+    // The front buffer may still be on its way to the panel
+    ssd1306_WaitForFlush(HAL_MAX_DELAY);
+
+#ifndef SSD1306_PAGE_MODE
+    ssd1306_SetWindow(x, x2, page1, page2);
+#endif
+    for (uint8_t page = page1; page <= page2; page++) {
+        uint8_t *panel = &SSD1306_Panel[SSD1306_WIDTH * page + x];
+#ifdef SSD1306_PAGE_MODE
+        ssd1306_SetWindow(x, x2, page, page);
+#endif
+        memcpy(panel, &SSD1306_Buffer[SSD1306_WIDTH * page + x], len);
+        ssd1306_WriteData(panel, len);
+
+        // Whatever else changed in the page is left for the next UpdateScreen,
+        // which skips the columns sent here since they now match the panel
+        if (x <= SSD1306_DirtyX1[page] && x2 >= SSD1306_DirtyX2[page]) {
+            SSD1306_DirtyX1[page] = SSD1306_WIDTH;
+            SSD1306_DirtyX2[page] = 0;
+        }
+    }
+
+    ssd1306_CountFlush(len * (page2 - page1 + 1));
+    return SSD1306_OK;
+}
+
+/* Start the next phase of the asynchronous flush, or finish it */
+static void ssd1306_FlushStep(void) {
+    while (SSD1306_SpanIndex < SSD1306_SpanCount) {
+        const SSD1306_Span_t *span = &SSD1306_Spans[SSD1306_SpanIndex];
+        SSD1306_Error_t status;
+
+        // The completion interrupt may run before WriteAsync returns and call
+        // back in here, so the step after this one is recorded first
+        if (SSD1306_SpanPhase == 0) {
+            uint8_t len = ssd1306_BuildWindow(SSD1306_WindowCmd, span->x1, span->x2, span->page, span->page2);
+            SSD1306_SpanPhase = 1;
+            status = ssd1306_WriteAsync(0, SSD1306_WindowCmd, len);
+        } else {
+            SSD1306_SpanPhase = 0;
+            SSD1306_SpanIndex++;
+            status = ssd1306_WriteAsync(1, ssd1306_SpanData(span), ssd1306_SpanLength(span));
+        }
+
+        if (status == SSD1306_OK) {
+            return;
+        }
+
+        // The transfer could not be started, the panel content is now unknown
+        ssd1306_WriteAsyncDone();
+        SSD1306_PanelValid = 0;
+        SSD1306_SpanIndex = 0;
+        SSD1306_SpanPhase = 0;
+        break;
+    }
+    SSD1306_FlushBusy = 0;
+}
+
+SSD1306_Error_t ssd1306_UpdateScreenAsync(void) {
+    if (SSD1306_FlushBusy) {
+        // Keep the dirty ranges, the caller retries later
+        return SSD1306_BUSY;
+    }
+
+    if (SSD1306_Transport->WriteAsync == NULL) {
+        // The transport has no asynchronous mode, fall back to a blocking flush
+        ssd1306_UpdateScreen();
+        return SSD1306_OK;
+    }
+
+    if (ssd1306_CollectSpans() == 0) {
+        return SSD1306_OK;
+    }
+
+    SSD1306_SpanIndex = 0;
+    SSD1306_SpanPhase = 0;
+    SSD1306_FlushBusy = 1;
+    ssd1306_FlushStep();
+    return SSD1306_OK;
+}
+
+uint8_t ssd1306_IsFlushBusy(void) {
+    return SSD1306_FlushBusy;
+}
+
+void ssd1306_FlushCpltCallback(void) {
+    if (!SSD1306_FlushBusy) {
+        return;
     }
+    ssd1306_WriteAsyncDone();
+    ssd1306_FlushStep();
+}
+
+void ssd1306_FlushErrorCallback(void) {
+    if (!SSD1306_FlushBusy) {
+        return;
+    }
+    ssd1306_WriteAsyncDone();
+    SSD1306_PanelValid = 0;
+    SSD1306_FlushBusy = 0;
+}
+
+SSD1306_Error_t ssd1306_WaitForFlush(uint32_t timeout) {
+    uint32_t start = HAL_GetTick();
+    while (SSD1306_FlushBusy) {
+        if (timeout != HAL_MAX_DELAY && (HAL_GetTick() - start) >= timeout) {
+            return SSD1306_BUSY;
+        }
+    }
+    return SSD1306_OK;
+}
+
+void ssd1306_InvalidateScreen(void) {
+    SSD1306_PanelValid = 0;
+    ssd1306_MarkDirty(0, 0, SSD1306_WIDTH - 1, SSD1306_HEIGHT - 1);
+}
+
+void ssd1306_GetFlushStats(SSD1306_FlushStats_t *stats) {
+    *stats = SSD1306_Stats;
+}
+
+void ssd1306_ResetFlushStats(void) {
+    memset(&SSD1306_Stats, 0, sizeof(SSD1306_Stats));
 }
 
 /*
@@ -203,12 +733,41 @@ void ssd1306_DrawPixel(uint8_t x, uint8_t y, SSD1306_COLOR color) {
         // Don't write outside the buffer
         return;
     }
-   
-    // Draw in the right color
-    if(color == White) {
-        SSD1306_Buffer[x + (y / 8) * SSD1306_WIDTH] |= 1 << (y % 8);
-    } else { 
-        SSD1306_Buffer[x + (y / 8) * SSD1306_WIDTH] &= ~(1 << (y % 8));
+
+    ssd1306_DrawPixelRaw(x, y, color);
+
+    // Inline dirty marking, this is the hot path of every primitive
+    const uint8_t page = y / 8;
+    if (x < SSD1306_DirtyX1[page]) SSD1306_DirtyX1[page] = x;
+    if (x > SSD1306_DirtyX2[page]) SSD1306_DirtyX2[page] = x;
+}
+
+/*
+ * Copy a page layout glyph to the cursor position, foreground and background.
+ * stride is the stored width of a glyph page, w the number of columns drawn.
+ * A glyph page lands on at most two screenbuffer pages: shifted down by y % 8
+ * into the first and the remaining bits into the next. The caller clips the cell.
+ */
+static void ssd1306_BlitGlyph(const uint8_t* glyph, uint8_t stride, uint8_t w, uint8_t h, SSD1306_COLOR color) {
+    const uint8_t shift = SSD1306.CurrentY % 8;
+    const uint8_t invert = (color == White) ? 0x00 : 0xFF;
+    uint8_t page = SSD1306.CurrentY / 8;
+
+    for (uint8_t row = 0; row < h; row += 8, page++, glyph += stride) {
+        // Rows of this glyph page that belong to the glyph
+        const uint8_t valid = (h - row >= 8) ? 0xFF : (uint8_t)((1 << (h - row)) - 1);
+        const uint8_t mask_lo = (uint8_t)(valid << shift);
+        const uint8_t mask_hi = (shift && page + 1 < SSD1306_PAGES) ? (uint8_t)(valid >> (8 - shift)) : 0;
+        uint8_t *lo = &SSD1306_Buffer[SSD1306_WIDTH * page + SSD1306.CurrentX];
+        uint8_t *hi = lo + SSD1306_WIDTH;
+
+        for (uint8_t x = 0; x < w; x++) {
+            const uint8_t bits = glyph[x] ^ invert;
+            lo[x] = (lo[x] & ~mask_lo) | ((uint8_t)(bits << shift) & mask_lo);
+            if (mask_hi) {
+                hi[x] = (hi[x] & ~mask_hi) | ((uint8_t)(bits >> (8 - shift)) & mask_hi);
+            }
+        }
     }
 }
 
@@ -225,8 +784,13 @@ char ssd1306_WriteChar(char ch, SSD1306_Font_t Font, SSD1306_COLOR color) {
     if (ch < 32 || ch > 126)
         return 0;
     
+    // Subset fonts only store some glyphs, the index maps the char to its slot
+    const uint32_t glyph = Font.glyph_index ? Font.glyph_index[ch - 32] : (uint32_t)(ch - 32);
+    if (glyph == SSD1306_GLYPH_NONE)
+        return 0;
+    
     // Char width is not equal to font width for proportional font
-    const uint8_t char_width = Font.char_width ? Font.char_width[ch-32] : Font.width;
+    const uint8_t char_width = Font.char_width ? Font.char_width[glyph] : Font.width;
     // Check remaining space on current line
     if (SSD1306_WIDTH < (SSD1306.CurrentX + char_width) ||
         SSD1306_HEIGHT < (SSD1306.CurrentY + Font.height))
@@ -235,14 +799,33 @@ char ssd1306_WriteChar(char ch, SSD1306_Font_t Font, SSD1306_COLOR color) {
         return 0;
     }
     
-    // Use the font to write
-    for(i = 0; i < Font.height; i++) {
-        b = Font.data[(ch - 32) * Font.height + i];
-        for(j = 0; j < char_width; j++) {
-            if((b << j) & 0x8000)  {
-                ssd1306_DrawPixel(SSD1306.CurrentX + j, (SSD1306.CurrentY + i), (SSD1306_COLOR) color);
-            } else {
-                ssd1306_DrawPixel(SSD1306.CurrentX + j, (SSD1306.CurrentY + i), (SSD1306_COLOR)!color);
+    // The glyph cell is rewritten completely, foreground and background
+    ssd1306_MarkDirty(SSD1306.CurrentX, SSD1306.CurrentY,
+                      SSD1306.CurrentX + char_width - 1, SSD1306.CurrentY + Font.height - 1);
+
+    if (Font.pages) {
+        ssd1306_BlitGlyph(&Font.pages[glyph * Font.width * ((Font.height + 7) / 8)],
+                          Font.width, char_width, Font.height, color);
+    } else if (Font.packed) {
+        // Rows of width bits, each glyph padded to a whole byte
+        const uint8_t *bits = &Font.packed[glyph * ((Font.width * Font.height + 7) / 8)];
+        for(i = 0; i < Font.height; i++) {
+            for(j = 0; j < char_width; j++) {
+                b = i * Font.width + j;
+                ssd1306_DrawPixelRaw(SSD1306.CurrentX + j, (SSD1306.CurrentY + i),
+                                     (bits[b / 8] & (0x80 >> (b % 8))) ? color : (SSD1306_COLOR)!color);
+            }
+        }
+    } else {
+        // Use the font to write
+        for(i = 0; i < Font.height; i++) {
+            b = Font.data[glyph * Font.height + i];
+            for(j = 0; j < char_width; j++) {
+                if((b << j) & 0x8000)  {
+                    ssd1306_DrawPixelRaw(SSD1306.CurrentX + j, (SSD1306.CurrentY + i), (SSD1306_COLOR) color);
+                } else {
+                    ssd1306_DrawPixelRaw(SSD1306.CurrentX + j, (SSD1306.CurrentY + i), (SSD1306_COLOR)!color);
+                }
             }
         }
     }
@@ -276,17 +859,27 @@ void ssd1306_SetCursor(uint8_t x, uint8_t y) {
 
 /* Draw line by Bresenhem's algorithm */
 void ssd1306_Line(uint8_t x1, uint8_t y1, uint8_t x2, uint8_t y2, SSD1306_COLOR color) {
+    if (x1 == x2 || y1 == y2) {
+        // Horizontal and vertical lines (bars, frames, gauges) are a single span
+        ssd1306_MarkDirty(x1, y1, x2, y2);
+        ssd1306_FillSpanRaw((x1 < x2) ? x1 : x2, (y1 < y2) ? y1 : y2,
+                            (x1 < x2) ? x2 : x1, (y1 < y2) ? y2 : y1, color);
+        return;
+    }
+
     int32_t deltaX = abs(x2 - x1);
     int32_t deltaY = abs(y2 - y1);
     int32_t signX = ((x1 < x2) ? 1 : -1);
     int32_t signY = ((y1 < y2) ? 1 : -1);
     int32_t error = deltaX - deltaY;
     int32_t error2;
+
+    ssd1306_MarkDirty(x1, y1, x2, y2);
     
-    ssd1306_DrawPixel(x2, y2, color);
+    ssd1306_DrawPixelRaw(x2, y2, color);
 
     while((x1 != x2) || (y1 != y2)) {
-        ssd1306_DrawPixel(x1, y1, color);
+        ssd1306_DrawPixelRaw(x1, y1, color);
         error2 = error * 2;
         if(error2 > -deltaY) {
             error -= deltaY;
@@ -430,11 +1023,13 @@ void ssd1306_DrawCircle(uint8_t par_x,uint8_t par_y,uint8_t par_r,SSD1306_COLOR
         return;
     }
 
+    ssd1306_MarkDirty(par_x - par_r, par_y - par_r, par_x + par_r, par_y + par_r);
+
     do {
-        ssd1306_DrawPixel(par_x - x, par_y + y, par_color);
-        ssd1306_DrawPixel(par_x + x, par_y + y, par_color);
-        ssd1306_DrawPixel(par_x + x, par_y - y, par_color);
-        ssd1306_DrawPixel(par_x - x, par_y - y, par_color);
+        ssd1306_DrawPixelRaw(par_x - x, par_y + y, par_color);
+        ssd1306_DrawPixelRaw(par_x + x, par_y + y, par_color);
+        ssd1306_DrawPixelRaw(par_x + x, par_y - y, par_color);
+        ssd1306_DrawPixelRaw(par_x - x, par_y - y, par_color);
         e2 = err;
 
         if (e2 <= y) {
@@ -465,12 +1060,11 @@ void ssd1306_FillCircle(uint8_t par_x,uint8_t par_y,uint8_t par_r,SSD1306_COLOR
         return;
     }
 
+    ssd1306_MarkDirty(par_x - par_r, par_y - par_r, par_x + par_r, par_y + par_r);
+
     do {
-        for (uint8_t _y = (par_y + y); _y >= (par_y - y); _y--) {
-            for (uint8_t _x = (par_x - x); _x >= (par_x + x); _x--) {
-                ssd1306_DrawPixel(_x, _y, par_color);
-            }
-        }
+        const int32_t box_x = x;
+        const int32_t box_y = y;
 
         e2 = err;
         if (e2 <= y) {
@@ -485,6 +1079,11 @@ void ssd1306_FillCircle(uint8_t par_x,uint8_t par_y,uint8_t par_r,SSD1306_COLOR
             x++;
             err = err + (x * 2 + 1);
         }
+
+        if (x != box_x) {
+            // Last step at this width, its box covers the shorter ones before it
+            ssd1306_FillSpanRaw(par_x + box_x, par_y - box_y, par_x - box_x, par_y + box_y, par_color);
+        }
     } while (x <= 0);
 
     return;
@@ -507,11 +1106,8 @@ void ssd1306_FillRectangle(uint8_t x1, uint8_t y1, uint8_t x2, uint8_t y2, SSD13
     uint8_t y_start = ((y1<=y2) ? y1 : y2);
     uint8_t y_end   = ((y1<=y2) ? y2 : y1);
 
-    for (uint8_t y= y_start; (y<= y_end)&&(y<SSD1306_HEIGHT); y++) {
-        for (uint8_t x= x_start; (x<= x_end)&&(x<SSD1306_WIDTH); x++) {
-            ssd1306_DrawPixel(x, y, color);
-        }
-    }
+    ssd1306_MarkDirty(x_start, y_start, x_end, y_end);
+    ssd1306_FillSpanRaw(x_start, y_start, x_end, y_end, color);
     return;
 }
 
@@ -522,6 +1118,7 @@ SSD1306_Error_t ssd1306_InvertRectangle(uint8_t x1, uint8_t y1, uint8_t x2, uint
   if ((x1 > x2) || (y1 > y2)) {
     return SSD1306_ERR;
   }
+  ssd1306_MarkDirty(x1, y1, x2, y2);
   uint32_t i;
   if ((y1 / 8) != (y2 / 8)) {
     /* if rectangle doesn't lie on one 8px row */
@@ -554,6 +1151,12 @@ void ssd1306_DrawBitmap(uint8_t x, uint8_t y, const unsigned char* bitmap, uint8
         return;
     }
 
+    if (w == 0 || h == 0) {
+        return;
+    }
+
+    ssd1306_MarkDirty(x, y, x + w - 1, y + h - 1);
+
     for (uint8_t j = 0; j < h; j++, y++) {
         for (uint8_t i = 0; i < w; i++) {
             if (i & 7) {
@@ -563,7 +1166,7 @@ void ssd1306_DrawBitmap(uint8_t x, uint8_t y, const unsigned char* bitmap, uint8
             }
 
             if (byte & 0x80) {
-                ssd1306_DrawPixel(x + i, y, color);
+                ssd1306_DrawPixelRaw(x + i, y, color);
             }
         }
     }
@@ -572,8 +1175,13 @@ void ssd1306_DrawBitmap(uint8_t x, uint8_t y, const unsigned char* bitmap, uint8
 
 void ssd1306_SetContrast(const uint8_t value) {
     const uint8_t kSetContrastControlRegister = 0x81;
-    ssd1306_WriteCommand(kSetContrastControlRegister);
-    ssd1306_WriteCommand(value);
+    const uint8_t cmd[2] = { kSetContrastControlRegister, value };
+    ssd1306_WriteCommands(cmd, sizeof(cmd));
+}
+
+void ssd1306_SetStartLine(const uint8_t line) {
+    const uint8_t kSetStartLineCommandBase = 0x40;
+    ssd1306_WriteCommand(kSetStartLineCommandBase | (line & 0x3F));
 }
 
 void ssd1306_SetDisplayOn(const uint8_t on) {
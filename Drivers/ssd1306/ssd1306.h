@@ -10,14 +10,20 @@
 
 #include <stddef.h>
 #include <stdint.h>
+#ifdef SSD1306_HOST
+#include "ssd1306_host.h"
+#else
 #include <_ansi.h>
+#endif
 
 _BEGIN_STD_C
 
 #include "ssd1306_conf.h"
 
 
-#if defined(STM32WB)
+#if defined(SSD1306_HOST)
+// Linux build, the HAL is replaced by ssd1306_host.c
+#elif defined(STM32WB)
 #include "stm32wbxx_hal.h"
 #elif defined(STM32F0)
 #include "stm32f0xx_hal.h"
@@ -100,7 +106,10 @@ _BEGIN_STD_C
 
 /* ^^^ SPI config ^^^ */
 
-#if defined(SSD1306_USE_I2C)
+#if defined(SSD1306_HOST)
+// Talks to the emulated controller, SSD1306_TransportHostAsync stands in for DMA
+#undef SSD1306_USE_DMA
+#elif defined(SSD1306_USE_I2C)
 extern I2C_HandleTypeDef SSD1306_I2C_PORT;
 #elif defined(SSD1306_USE_SPI)
 extern SPI_HandleTypeDef SSD1306_SPI_PORT;
@@ -122,6 +131,9 @@ extern SPI_HandleTypeDef SSD1306_SPI_PORT;
 #define SSD1306_BUFFER_SIZE   SSD1306_WIDTH * SSD1306_HEIGHT / 8
 #endif
 
+// Number of 8-pixel RAM pages
+#define SSD1306_PAGES           (SSD1306_HEIGHT / 8)
+
 // Enumeration for screen colors
 typedef enum {
     Black = 0x00, // Black color, no pixel
@@ -130,9 +142,37 @@ typedef enum {
 
 typedef enum {
     SSD1306_OK = 0x00,
-    SSD1306_ERR = 0x01  // Generic error.
+    SSD1306_ERR = 0x01, // Generic error.
+    SSD1306_BUSY = 0x02 // An asynchronous flush is still in progress.
 } SSD1306_Error_t;
 
+/**
+ * Bus transport. Dirty tracking, flush statistics and the asynchronous flush
+ * are built on top of it, so they run unchanged over any transport.
+ */
+typedef struct {
+    void (*Begin)(void);                                        // Reset the panel, ready the bus
+    void (*WriteCommands)(const uint8_t* cmds, size_t count);   // Blocking, one transaction
+    void (*WriteData)(const uint8_t* data, size_t count);       // Blocking, one transaction
+    // Starts a transfer and returns, its end is reported through ssd1306_FlushCpltCallback()
+    // or ssd1306_FlushErrorCallback(). NULL when the transport only blocks.
+    SSD1306_Error_t (*WriteAsync)(uint8_t is_data, const uint8_t* buffer, size_t count);
+    void (*Complete)(void);                                     // Optional, runs when an async transfer ended
+} SSD1306_Transport_t;
+
+// Transports built for the bus selected in ssd1306_conf.h
+#if defined(SSD1306_HOST)
+extern const SSD1306_Transport_t SSD1306_TransportHost;        // Emulated controller, blocking
+extern const SSD1306_Transport_t SSD1306_TransportHostAsync;   // Emulated controller, see ssd1306_HostCompleteTransfer()
+extern const SSD1306_Transport_t SSD1306_TransportHostInline;  // Emulated controller, completes inside WriteAsync
+#elif defined(SSD1306_USE_I2C)
+extern const SSD1306_Transport_t SSD1306_TransportI2C;
+extern const SSD1306_Transport_t SSD1306_TransportI2C_DMA;     // Needs a TX DMA channel on the I2C handle
+#elif defined(SSD1306_USE_SPI)
+extern const SSD1306_Transport_t SSD1306_TransportSPI;
+extern const SSD1306_Transport_t SSD1306_TransportSPI_DMA;     // Needs a TX DMA channel on the SPI handle
+#endif
+
 // Struct to store transformations
 typedef struct {
     uint16_t CurrentX;
@@ -146,16 +186,39 @@ typedef struct {
     uint8_t y;
 } SSD1306_VERTEX;
 
+// Bus traffic of ssd1306_UpdateScreen(), data bytes only
+typedef struct {
+    uint32_t Flushes;           // Number of UpdateScreen calls
+    uint32_t LastBytesSent;     // Bytes sent by the last flush
+    uint32_t LastBytesSaved;    // Bytes the last flush did not have to send
+    uint32_t TotalBytesSent;
+    uint32_t TotalBytesSaved;
+    uint32_t Transactions;      // Bus transactions started, commands and data, including init
+} SSD1306_FlushStats_t;
+
 /** Font */
 typedef struct {
 	const uint8_t width;                /**< Font width in pixels */
 	const uint8_t height;               /**< Font height in pixels */
 	const uint16_t *const data;         /**< Pointer to font data array */
     const uint8_t *const char_width;    /**< Proportional character width in pixels (NULL for monospaced) */
+    const uint8_t *const pages;         /**< Glyphs in page layout from tools/font_pages.py (NULL to render from data) */
+    const uint8_t *const glyph_index;   /**< Glyph slot of chars 32..126, SSD1306_GLYPH_NONE if absent (NULL: all present) */
+    const uint8_t *const packed;        /**< Rows packed at width bits, from tools/font_pack.py (NULL to use data) */
 } SSD1306_Font_t;
 
+/** Marks a character left out of a subset font in SSD1306_Font_t.glyph_index */
+#define SSD1306_GLYPH_NONE  0xFF
+
 // Procedure definitions
 void ssd1306_Init(void);
+
+/**
+ * @brief Selects the bus transport and initializes the display with it.
+ * @note ssd1306_Init() keeps the transport picked by ssd1306_conf.h: the DMA one
+ *       with SSD1306_USE_DMA, the blocking one otherwise.
+ */
+void ssd1306_InitTransport(const SSD1306_Transport_t* transport);
 void ssd1306_Fill(SSD1306_COLOR color);
 void ssd1306_UpdateScreen(void);
 void ssd1306_DrawPixel(uint8_t x, uint8_t y, SSD1306_COLOR color);
@@ -192,6 +255,13 @@ void ssd1306_DrawBitmap(uint8_t x, uint8_t y, const unsigned char* bitmap, uint8
  */
 void ssd1306_SetContrast(const uint8_t value);
 
+/**
+ * @brief Sets the RAM row shown on the top line of the panel, for hardware scrolling.
+ * @param[in] line RAM row 0..63. The screenbuffer keeps the RAM layout: with
+ *            line = 8 * p, page p is on top and the pages before it wrap to the bottom.
+ */
+void ssd1306_SetStartLine(const uint8_t line);
+
 /**
  * @brief Set Display ON/OFF.
  * @param[in] on 0 for OFF, any for ON.
@@ -205,9 +275,78 @@ void ssd1306_SetDisplayOn(const uint8_t on);
  */
 uint8_t ssd1306_GetDisplayOn();
 
+/**
+ * @brief Writes a rectangle of the screenbuffer to the screen, blocking.
+ * @param x, y Top-left corner in pixels.
+ * @param w, h Size in pixels, clipped to the screen. Rows are rounded out to whole pages.
+ * @note For callers that know exactly what they drew. Waits for a running
+ *       asynchronous flush; the rest of the changes stay for ssd1306_UpdateScreen().
+ * @return SSD1306_OK, SSD1306_ERR when the rectangle is empty or off screen.
+ */
+SSD1306_Error_t ssd1306_UpdateRegion(uint8_t x, uint8_t y, uint8_t w, uint8_t h);
+
+/**
+ * @brief Starts a non-blocking flush of the changed parts of the screenbuffer.
+ * @note Drawing may continue while the transfer runs, the next frame is built
+ *       in the back buffer. Needs a transport with WriteAsync, otherwise the flush blocks.
+ * @return SSD1306_OK when started (or nothing changed), SSD1306_BUSY when the
+ *         previous flush has not finished yet; the changes are kept for the next call.
+ */
+SSD1306_Error_t ssd1306_UpdateScreenAsync(void);
+
+/**
+ * @brief Reads the asynchronous flush state.
+ * @return  0: idle.
+ *          1: a flush is in progress.
+ */
+uint8_t ssd1306_IsFlushBusy(void);
+
+/**
+ * @brief Waits for the asynchronous flush to complete.
+ * @param[in] timeout Maximum wait in ms, HAL_MAX_DELAY waits forever.
+ * @return SSD1306_OK when idle, SSD1306_BUSY on timeout.
+ */
+SSD1306_Error_t ssd1306_WaitForFlush(uint32_t timeout);
+
+/**
+ * @brief Advances the asynchronous flush, call from the bus transfer complete callback
+ *        (HAL_I2C_MemTxCpltCallback or HAL_SPI_TxCpltCallback).
+ */
+void ssd1306_FlushCpltCallback(void);
+
+/**
+ * @brief Aborts the asynchronous flush, call from the bus error callback.
+ */
+void ssd1306_FlushErrorCallback(void);
+
+/**
+ * @brief Loads a complete frame into the screenbuffer, e.g. a static screen from tools/screen_pack.py.
+ * @param screen SSD1306_BUFFER_SIZE bytes in page layout, may live in flash.
+ * @note Draw the dynamic fields afterwards, then flush as usual.
+ */
+void ssd1306_LoadScreen(const uint8_t* screen);
+
+/**
+ * @brief Forces the next ssd1306_UpdateScreen() to resend the whole buffer.
+ * @note Use after the panel lost its RAM contents (power cycle, reset).
+ */
+void ssd1306_InvalidateScreen(void);
+
+/**
+ * @brief Reads the flush statistics.
+ * @param[out] stats Destination for a copy of the counters.
+ */
+void ssd1306_GetFlushStats(SSD1306_FlushStats_t *stats);
+
+/**
+ * @brief Clears the flush statistics.
+ */
+void ssd1306_ResetFlushStats(void);
+
 // Low-level procedures
 void ssd1306_Reset(void);
 void ssd1306_WriteCommand(uint8_t byte);
+void ssd1306_WriteCommands(const uint8_t* cmds, size_t count);
 void ssd1306_WriteData(uint8_t* buffer, size_t buff_size);
 SSD1306_Error_t ssd1306_FillBuffer(uint8_t* buf, uint32_t len);
 
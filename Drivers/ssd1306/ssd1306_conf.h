@@ -23,6 +23,19 @@
 #define SSD1306_USE_I2C
 //#define SSD1306_USE_SPI
 
+// Default to the DMA transport (SSD1306_TransportI2C_DMA or SSD1306_TransportSPI_DMA),
+// see ssd1306_UpdateScreenAsync(). The bus handle needs a TX DMA channel and its
+// interrupts enabled. ssd1306_InitTransport() can pick another transport at run time.
+#define SSD1306_USE_DMA
+
+// Send the whole frame with one window and a single data transfer when
+// most of it changed (boot, full redraws) instead of page by page.
+#define SSD1306_FULL_FRAME_BURST
+
+// SH1106 and other controllers without horizontal addressing (0x20/0x21/0x22):
+// address the panel page by page. Disables SSD1306_FULL_FRAME_BURST.
+// #define SSD1306_PAGE_MODE
+
 // I2C Configuration
 #define SSD1306_I2C_PORT        hi2c1
 #define SSD1306_I2C_ADDR        (0x3C << 1)
@@ -45,13 +58,18 @@
 
 // Include only needed fonts
 #define SSD1306_INCLUDE_FONT_6x8
-#define SSD1306_INCLUDE_FONT_7x10
+// #define SSD1306_INCLUDE_FONT_7x10
 #define SSD1306_INCLUDE_FONT_11x18
-#define SSD1306_INCLUDE_FONT_16x26
+// #define SSD1306_INCLUDE_FONT_16x26
+
+// #define SSD1306_INCLUDE_FONT_16x24
 
-#define SSD1306_INCLUDE_FONT_16x24
+// #define SSD1306_INCLUDE_FONT_16x15
 
-#define SSD1306_INCLUDE_FONT_16x15
+// Take the fonts from ssd1306_fonts_subset.c instead of ssd1306_fonts.c.
+// It holds only the characters listed in tools/font_charset.txt,
+// regenerate it with tools/font_pack.py after changing the list.
+#define SSD1306_USE_FONT_SUBSET
 
 // The width of the screen can be set using this
 // define. The default value is 128.
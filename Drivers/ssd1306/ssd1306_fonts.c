@@ -1,6 +1,9 @@
 
 #include "ssd1306_fonts.h"
 
+// Full tables, replaced by ssd1306_fonts_subset.c when SSD1306_USE_FONT_SUBSET is set
+#ifndef SSD1306_USE_FONT_SUBSET
+
 #ifdef SSD1306_INCLUDE_FONT_7x10
 static const uint16_t Font7x10 [] = {
 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,  // sp
@@ -894,22 +897,25 @@ static const uint8_t char_width[] = {
 };
 #endif
 
+// Page layout copies of the tables above, regenerate with tools/font_pages.py
+#include "ssd1306_fonts_pages.h"
+
 #ifdef SSD1306_INCLUDE_FONT_6x8
-const SSD1306_Font_t Font_6x8 = {6, 8, Font6x8, NULL};
+const SSD1306_Font_t Font_6x8 = {6, 8, Font6x8, NULL, Font6x8_pages};
 #endif
 #ifdef SSD1306_INCLUDE_FONT_7x10
-const SSD1306_Font_t Font_7x10 = {7, 10, Font7x10, NULL};
+const SSD1306_Font_t Font_7x10 = {7, 10, Font7x10, NULL, Font7x10_pages};
 #endif
 #ifdef SSD1306_INCLUDE_FONT_11x18
-const SSD1306_Font_t Font_11x18 = {11, 18, Font11x18, NULL};
+const SSD1306_Font_t Font_11x18 = {11, 18, Font11x18, NULL, Font11x18_pages};
 #endif
 #ifdef SSD1306_INCLUDE_FONT_16x26
-const SSD1306_Font_t Font_16x26 = {16, 26, Font16x26, NULL};
+const SSD1306_Font_t Font_16x26 = {16, 26, Font16x26, NULL, Font16x26_pages};
 #endif
 
 /* see ./examples/custom-fonts/ */
 #ifdef SSD1306_INCLUDE_FONT_16x24
-const SSD1306_Font_t Font_16x24 = {16, 24, Font16x24, NULL};
+const SSD1306_Font_t Font_16x24 = {16, 24, Font16x24, NULL, Font16x24_pages};
 #endif
 
 #ifdef SSD1306_INCLUDE_FONT_16x15
@@ -917,5 +923,7 @@ const SSD1306_Font_t Font_16x24 = {16, 24, Font16x24, NULL};
  * @copyright Google https://github.com/googlefonts/roboto
  * @license This font is licensed under the Apache License, Version 2.0.
 */
-const SSD1306_Font_t Font_16x15 = {16, 15, Font16x15, char_width};
+const SSD1306_Font_t Font_16x15 = {16, 15, Font16x15, char_width, Font16x15_pages};
 #endif
+
+#endif // SSD1306_USE_FONT_SUBSET
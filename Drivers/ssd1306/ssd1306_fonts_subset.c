@@ -0,0 +1,126 @@
+/*
+ * Glyph subsets of the fonts in ssd1306_fonts.c, see tools/font_pack.py.
+ * Generated from tools/font_charset.txt, do not edit.
+ */
+
+#include "ssd1306_fonts.h"
+
+#ifdef SSD1306_USE_FONT_SUBSET
+
+#ifdef SSD1306_INCLUDE_FONT_11x18
+// 11x18: 46 of 95 glyphs
+static const uint8_t Font11x18_index [] = {
+0x00, 0xFF, 0xFF, 0x01, 0xFF, 0x02, 0xFF, 0xFF, 0xFF, 0xFF, 0x03, 0xFF, 0xFF, 0x04, 0x05, 0xFF,
+0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F, 0x10, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+0xFF, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0x1A, 0x1B, 0x1C, 0x1D, 0x1E, 0x1F,
+0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27, 0x28, 0x29, 0x2A, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x2B, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x2C, 0xFF, 0xFF,
+0x2D, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+};
+static const uint8_t Font11x18_pages [] = {
+0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,  // sp
+0x00, 0x60, 0x60, 0xFE, 0xFE, 0x60, 0x60, 0xFE, 0xFE, 0x60, 0x00, 0x00, 0x06, 0x7F, 0x7F, 0x06, 0x06, 0x7F, 0x7F, 0x06, 0x06, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,  // #
+0x3C, 0x7E, 0x42, 0x7E, 0x3C, 0x80, 0xC0, 0x60, 0x30, 0x18, 0x00, 0x00, 0x18, 0x0C, 0x06, 0x03, 0x3D, 0x7E, 0x42, 0x7E, 0x3C, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,  // %
+0x00, 0x00, 0x2C, 0x38, 0x1E, 0x1E, 0x38, 0x2C, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,  // *
+0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x06, 0x06, 0x06, 0x06, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,  // -
+0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x60, 0x60, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,  // .
+0x00, 0xF0, 0xFC, 0x0E, 0x86, 0x86, 0x0E, 0xFC, 0xF0, 0x00, 0x00, 0x00, 0x0F, 0x3F, 0x70, 0x61, 0x61, 0x70, 0x3F, 0x0F, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,  // 0
+0x00, 0x00, 0x30, 0x18, 0x0C, 0xFE, 0xFE, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x7F, 0x7F, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,  // 1
+0x00, 0x38, 0x3C, 0x0E, 0x06, 0x06, 0x8E, 0xFC, 0x78, 0x00, 0x00, 0x00, 0x70, 0x78, 0x6C, 0x66, 0x63, 0x61, 0x60, 0x60, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,  // 2
+0x00, 0x18, 0x1C, 0x06, 0xC6, 0xC6, 0xFC, 0x38, 0x00, 0x00, 0x00, 0x00, 0x18, 0x38, 0x70, 0x60, 0x60, 0x71, 0x3F, 0x1E, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,  // 3
+0x00, 0x00, 0x80, 0xF0, 0x3C, 0xFE, 0xFE, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0E, 0x0F, 0x0D, 0x0C, 0x7F, 0x7F, 0x0C, 0x0C, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,  // 4
+0x00, 0xFE, 0xFE, 0x86, 0xC6, 0xC6, 0xC6, 0x86, 0x00, 0x00, 0x00, 0x00, 0x19, 0x39, 0x70, 0x60, 0x60, 0x71, 0x3F, 0x1F, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,  // 5
+0x00, 0xF0, 0xFC, 0x8E, 0xC6, 0xC6, 0xCE, 0x9C, 0x18, 0x00, 0x00, 0x00, 0x0F, 0x3F, 0x71, 0x60, 0x60, 0x71, 0x3F, 0x1F, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,  // 6
+0x00, 0x06, 0x06, 0x06, 0x06, 0xC6, 0xF6, 0x3E, 0x0E, 0x00, 0x00, 0x00, 0x00, 0x00, 0x70, 0x7F, 0x07, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,  // 7
+0x00, 0x38, 0x7C, 0x86, 0x86, 0x86, 0x8E, 0x7C, 0x38, 0x00, 0x00, 0x00, 0x1E, 0x3F, 0x61, 0x61, 0x61, 0x61, 0x3F, 0x1E, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,  // 8
+0x00, 0xF8, 0xFC, 0x8E, 0x06, 0x06, 0x8E, 0xFC, 0xF0, 0x00, 0x00, 0x00, 0x18, 0x39, 0x73, 0x63, 0x63, 0x71, 0x3F, 0x0F, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,  // 9
+0x00, 0x00, 0x00, 0x00, 0x60, 0x60, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x60, 0x60, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,  // :
+0x00, 0x00, 0x80, 0xF8, 0x7E, 0x06, 0x7E, 0xF8, 0x80, 0x00, 0x00, 0x00, 0x70, 0x7F, 0x0F, 0x06, 0x06, 0x06, 0x0F, 0x7F, 0x70, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,  // A
+0x00, 0xFE, 0xFE, 0x86, 0x86, 0x86, 0xFC, 0x78, 0x00, 0x00, 0x00, 0x00, 0x7F, 0x7F, 0x61, 0x61, 0x61, 0x73, 0x3E, 0x1C, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,  // B
+0x00, 0xF0, 0xFC, 0x0E, 0x06, 0x06, 0x06, 0x1C, 0x18, 0x00, 0x00, 0x00, 0x0F, 0x3F, 0x70, 0x60, 0x60, 0x60, 0x38, 0x18, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,  // C
+0x00, 0xFE, 0xFE, 0x06, 0x06, 0x06, 0x1C, 0xFC, 0xF0, 0x00, 0x00, 0x00, 0x7F, 0x7F, 0x60, 0x60, 0x60, 0x38, 0x1F, 0x07, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,  // D
+0x00, 0xFE, 0xFE, 0x86, 0x86, 0x86, 0x86, 0x86, 0x06, 0x00, 0x00, 0x00, 0x7F, 0x7F, 0x61, 0x61, 0x61, 0x61, 0x61, 0x60, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,  // E
+0x00, 0xFE, 0xFE, 0x86, 0x86, 0x86, 0x86, 0x86, 0x06, 0x00, 0x00, 0x00, 0x7F, 0x7F, 0x01, 0x01, 0x01, 0x01, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,  // F
+0x00, 0xF0, 0xFC, 0x0E, 0x06, 0x06, 0x06, 0x1C, 0x18, 0x00, 0x00, 0x00, 0x0F, 0x3F, 0x70, 0x60, 0x60, 0x63, 0x3F, 0x3F, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,  // G
+0x00, 0xFE, 0xFE, 0x80, 0x80, 0x80, 0x80, 0xFE, 0xFE, 0x00, 0x00, 0x00, 0x7F, 0x7F, 0x01, 0x01, 0x01, 0x01, 0x7F, 0x7F, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,  // H
+0x00, 0x00, 0x06, 0x06, 0xFE, 0xFE, 0x06, 0x06, 0x00, 0x00, 0x00, 0x00, 0x00, 0x60, 0x60, 0x7F, 0x7F, 0x60, 0x60, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,  // I
+0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xFE, 0xFE, 0x00, 0x00, 0x00, 0x1C, 0x3C, 0x70, 0x60, 0x60, 0x70, 0x3F, 0x1F, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,  // J
+0x00, 0xFE, 0xFE, 0x80, 0xC0, 0x70, 0x38, 0x0C, 0x06, 0x02, 0x00, 0x00, 0x7F, 0x7F, 0x01, 0x01, 0x07, 0x0E, 0x38, 0x70, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,  // K
+0x00, 0xFE, 0xFE, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x7F, 0x7F, 0x60, 0x60, 0x60, 0x60, 0x60, 0x60, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,  // L
+0x00, 0xFE, 0xFE, 0x1E, 0xF8, 0x80, 0xF8, 0x0E, 0xFE, 0xFE, 0x00, 0x00, 0x7F, 0x7F, 0x00, 0x00, 0x01, 0x00, 0x00, 0x7F, 0x7F, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,  // M
+0x00, 0xFE, 0xFE, 0x3E, 0xF8, 0xC0, 0x00, 0xFE, 0xFE, 0x00, 0x00, 0x00, 0x7F, 0x7F, 0x00, 0x01, 0x1F, 0x7C, 0x7F, 0x7F, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,  // N
+0x00, 0xF0, 0xFC, 0x0E, 0x06, 0x06, 0x0E, 0xFC, 0xF0, 0x00, 0x00, 0x00, 0x0F, 0x3F, 0x70, 0x60, 0x60, 0x70, 0x3F, 0x0F, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,  // O
+0x00, 0xFE, 0xFE, 0x06, 0x06, 0x06, 0x8E, 0xFC, 0xF8, 0x00, 0x00, 0x00, 0x7F, 0x7F, 0x03, 0x03, 0x03, 0x03, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,  // P
+0x00, 0xF0, 0xFC, 0x0E, 0x06, 0x06, 0x0E, 0xFC, 0xF0, 0x00, 0x00, 0x00, 0x0F, 0x3F, 0x70, 0x60, 0x6C, 0x78, 0x3F, 0x2F, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,  // Q
+0x00, 0xFE, 0xFE, 0x86, 0x86, 0x86, 0xCE, 0xFC, 0x78, 0x00, 0x00, 0x00, 0x7F, 0x7F, 0x01, 0x01, 0x03, 0x0F, 0x3C, 0x70, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,  // R
+0x00, 0x00, 0x78, 0xFC, 0xC6, 0x86, 0x86, 0x1C, 0x18, 0x00, 0x00, 0x00, 0x0C, 0x3C, 0x70, 0x60, 0x61, 0x63, 0x3F, 0x1E, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,  // S
+0x06, 0x06, 0x06, 0x06, 0xFE, 0xFE, 0x06, 0x06, 0x06, 0x06, 0x00, 0x00, 0x00, 0x00, 0x00, 0x7F, 0x7F, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,  // T
+0x00, 0xFE, 0xFE, 0x00, 0x00, 0x00, 0x00, 0xFE, 0xFE, 0x00, 0x00, 0x00, 0x1F, 0x3F, 0x70, 0x60, 0x60, 0x70, 0x3F, 0x1F, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,  // U
+0x00, 0x0E, 0x7E, 0xF0, 0x80, 0x00, 0x80, 0xF0, 0x7E, 0x0E, 0x00, 0x00, 0x00, 0x00, 0x07, 0x3F, 0x78, 0x3F, 0x07, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,  // V
+0x7E, 0xFE, 0x00, 0x00, 0xC0, 0xC0, 0x00, 0x00, 0xFE, 0x7E, 0x00, 0x00, 0x7F, 0x70, 0x1E, 0x03, 0x03, 0x1E, 0x70, 0x7F, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,  // W
+0x02, 0x0E, 0x3C, 0x70, 0xE0, 0xC0, 0x70, 0x38, 0x0E, 0x02, 0x00, 0x40, 0x70, 0x38, 0x1E, 0x0F, 0x07, 0x0E, 0x3C, 0x70, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,  // X
+0x02, 0x0E, 0x3C, 0xF0, 0xC0, 0xC0, 0xF0, 0x3C, 0x0E, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x7F, 0x7F, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,  // Y
+0x00, 0x00, 0x06, 0x06, 0x86, 0xC6, 0x76, 0x3E, 0x0E, 0x00, 0x00, 0x00, 0x70, 0x78, 0x6E, 0x67, 0x61, 0x60, 0x60, 0x60, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,  // Z
+0x00, 0x80, 0xC0, 0xE0, 0x60, 0x60, 0xE0, 0xC0, 0x00, 0x00, 0x00, 0x00, 0x1F, 0x3F, 0x76, 0x66, 0x66, 0x66, 0x37, 0x17, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,  // e
+0xE0, 0xE0, 0x40, 0x60, 0xE0, 0xE0, 0xC0, 0x60, 0xE0, 0xC0, 0x00, 0x7F, 0x7F, 0x00, 0x00, 0x7F, 0x7F, 0x00, 0x00, 0x7F, 0x7F, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,  // m
+0x00, 0xF0, 0xF0, 0x60, 0x30, 0x30, 0x70, 0xE0, 0xC0, 0x00, 0x00, 0x00, 0xFF, 0xFF, 0x18, 0x30, 0x30, 0x38, 0x1F, 0x0F, 0x00, 0x00, 0x00, 0x03, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,  // p
+};
+const SSD1306_Font_t Font_11x18 = {11, 18, NULL, NULL, Font11x18_pages, Font11x18_index, NULL};
+#endif
+
+#ifdef SSD1306_INCLUDE_FONT_6x8
+// 6x8: 40 of 95 glyphs
+static const uint8_t Font6x8_index [] = {
+0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0x01, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x02, 0xFF, 0xFF,
+0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+0xFF, 0x0E, 0x0F, 0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0x1A, 0x1B, 0x1C,
+0x1D, 0x1E, 0x1F, 0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+};
+static const uint8_t Font6x8_pages [] = {
+0x00, 0x00, 0x00, 0x00, 0x00, 0x00,  // sp
+0x23, 0x13, 0x08, 0x64, 0x62, 0x00,  // %
+0x08, 0x08, 0x08, 0x08, 0x08, 0x00,  // -
+0x3E, 0x51, 0x49, 0x45, 0x3E, 0x00,  // 0
+0x00, 0x42, 0x7F, 0x40, 0x00, 0x00,  // 1
+0x72, 0x49, 0x49, 0x49, 0x46, 0x00,  // 2
+0x21, 0x41, 0x49, 0x4D, 0x33, 0x00,  // 3
+0x18, 0x14, 0x12, 0x7F, 0x10, 0x00,  // 4
+0x27, 0x45, 0x45, 0x45, 0x39, 0x00,  // 5
+0x3C, 0x4A, 0x49, 0x49, 0x31, 0x00,  // 6
+0x41, 0x21, 0x11, 0x09, 0x07, 0x00,  // 7
+0x36, 0x49, 0x49, 0x49, 0x36, 0x00,  // 8
+0x46, 0x49, 0x49, 0x29, 0x1E, 0x00,  // 9
+0x00, 0x00, 0x14, 0x00, 0x00, 0x00,  // :
+0x7C, 0x12, 0x11, 0x12, 0x7C, 0x00,  // A
+0x7F, 0x49, 0x49, 0x49, 0x36, 0x00,  // B
+0x3E, 0x41, 0x41, 0x41, 0x22, 0x00,  // C
+0x7F, 0x41, 0x41, 0x41, 0x3E, 0x00,  // D
+0x7F, 0x49, 0x49, 0x49, 0x41, 0x00,  // E
+0x7F, 0x09, 0x09, 0x09, 0x01, 0x00,  // F
+0x3E, 0x41, 0x41, 0x51, 0x73, 0x00,  // G
+0x7F, 0x08, 0x08, 0x08, 0x7F, 0x00,  // H
+0x00, 0x41, 0x7F, 0x41, 0x00, 0x00,  // I
+0x20, 0x40, 0x41, 0x3F, 0x01, 0x00,  // J
+0x7F, 0x08, 0x14, 0x22, 0x41, 0x00,  // K
+0x7F, 0x40, 0x40, 0x40, 0x40, 0x00,  // L
+0x7F, 0x02, 0x1C, 0x02, 0x7F, 0x00,  // M
+0x7F, 0x04, 0x08, 0x10, 0x7F, 0x00,  // N
+0x3E, 0x41, 0x41, 0x41, 0x3E, 0x00,  // O
+0x7F, 0x09, 0x09, 0x09, 0x06, 0x00,  // P
+0x3E, 0x41, 0x51, 0x21, 0x5E, 0x00,  // Q
+0x7F, 0x09, 0x19, 0x29, 0x46, 0x00,  // R
+0x26, 0x49, 0x49, 0x49, 0x32, 0x00,  // S
+0x03, 0x01, 0x7F, 0x01, 0x03, 0x00,  // T
+0x3F, 0x40, 0x40, 0x40, 0x3F, 0x00,  // U
+0x1F, 0x20, 0x40, 0x20, 0x1F, 0x00,  // V
+0x3F, 0x40, 0x38, 0x40, 0x3F, 0x00,  // W
+0x63, 0x14, 0x08, 0x14, 0x63, 0x00,  // X
+0x03, 0x04, 0x78, 0x04, 0x03, 0x00,  // Y
+0x61, 0x59, 0x49, 0x4D, 0x43, 0x00,  // Z
+};
+const SSD1306_Font_t Font_6x8 = {6, 8, NULL, NULL, Font6x8_pages, Font6x8_index, NULL};
+#endif
+
+#endif // SSD1306_USE_FONT_SUBSET
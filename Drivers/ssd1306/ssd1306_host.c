@@ -0,0 +1,343 @@
+#include "ssd1306.h"
+
+#ifdef SSD1306_HOST
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+// GDDRAM size, SH1106 style panels address 132 columns
+#define HOST_PAGES      8
+#define HOST_COLUMNS    132
+#define HOST_ROWS       (HOST_PAGES * 8)
+
+// State of the emulated controller
+typedef struct {
+    uint8_t Ram[HOST_PAGES][HOST_COLUMNS];
+    uint8_t Mode;               // 0 horizontal, 1 vertical, 2 page addressing
+    uint8_t Column;             // Write pointer
+    uint8_t Page;
+    uint8_t ColumnStart;        // Window of horizontal and vertical addressing
+    uint8_t ColumnEnd;
+    uint8_t PageStart;
+    uint8_t PageEnd;
+    uint8_t StartLine;
+    uint8_t Offset;             // Display offset (0xD3)
+    uint8_t Contrast;
+    uint8_t SegmentRemap;       // 0xA1: column 0 on the right edge of the glass
+    uint8_t ComRemap;           // 0xC8: scan from COM[N-1]
+    uint8_t Inverse;
+    uint8_t EntireOn;
+    uint8_t DisplayOn;
+
+    uint8_t Command;            // Command waiting for its arguments
+    uint8_t ArgsNeeded;
+    uint8_t ArgCount;
+    uint8_t Args[6];
+
+    SSD1306_HostBus_t Bus;
+} SSD1306_Host_t;
+
+static SSD1306_Host_t Host;
+
+// Manual clock set by ssd1306_HostSetTick()
+static uint8_t HostTickManual = 0;
+static uint32_t HostTick = 0;
+
+uint32_t HAL_GetTick(void) {
+    if (HostTickManual) {
+        return HostTick;
+    }
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint32_t)(now.tv_sec * 1000u + now.tv_nsec / 1000000u);
+}
+
+void HAL_Delay(uint32_t delay) {
+    if (HostTickManual) {
+        HostTick += delay;
+        return;
+    }
+    struct timespec ts = { delay / 1000u, (long)(delay % 1000u) * 1000000L };
+    nanosleep(&ts, NULL);
+}
+
+void ssd1306_HostSetTick(uint32_t ms) {
+    HostTickManual = 1;
+    HostTick = ms;
+}
+
+void ssd1306_HostPowerOn(void) {
+    SSD1306_HostBus_t bus = Host.Bus;
+    memset(&Host, 0, sizeof(Host));
+    Host.Bus = bus;
+    Host.Mode = 2;
+    Host.ColumnEnd = 127;
+    Host.PageEnd = HOST_PAGES - 1;
+    Host.Contrast = 0x7F;
+}
+
+/* Number of argument bytes that follow a command */
+static uint8_t ssd1306_HostArgCount(uint8_t cmd) {
+    switch (cmd) {
+    case 0x20: case 0x81: case 0x8D: case 0xA8: case 0xD3:
+    case 0xD5: case 0xD9: case 0xDA: case 0xDB: case 0xAD:
+        return 1;
+    case 0x21: case 0x22: case 0xA3:
+        return 2;
+    case 0x29: case 0x2A:
+        return 5;
+    case 0x26: case 0x27:
+        return 6;
+    default:
+        return 0;
+    }
+}
+
+/* Apply a command once all its arguments arrived */
+static void ssd1306_HostExecute(uint8_t cmd, const uint8_t* args) {
+    switch (cmd) {
+    case 0x20:
+        Host.Mode = args[0] & 0x03;
+        break;
+    case 0x21:
+        Host.ColumnStart = args[0] % HOST_COLUMNS;
+        Host.ColumnEnd = args[1] % HOST_COLUMNS;
+        Host.Column = Host.ColumnStart;
+        break;
+    case 0x22:
+        Host.PageStart = args[0] % HOST_PAGES;
+        Host.PageEnd = args[1] % HOST_PAGES;
+        Host.Page = Host.PageStart;
+        break;
+    case 0x81:
+        Host.Contrast = args[0];
+        break;
+    case 0xD3:
+        Host.Offset = args[0] % HOST_ROWS;
+        break;
+    default:
+        if (cmd <= 0x0F) {
+            Host.Column = (Host.Column & 0xF0) | cmd;
+        } else if (cmd >= 0x10 && cmd <= 0x1F) {
+            Host.Column = ((cmd & 0x0F) << 4) | (Host.Column & 0x0F);
+        } else if (cmd >= 0x40 && cmd <= 0x7F) {
+            Host.StartLine = cmd & 0x3F;
+        } else if (cmd >= 0xB0 && cmd <= 0xB7) {
+            Host.Page = cmd & 0x07;
+        } else if (cmd == 0xA0 || cmd == 0xA1) {
+            Host.SegmentRemap = cmd & 0x01;
+        } else if (cmd == 0xA4 || cmd == 0xA5) {
+            Host.EntireOn = cmd & 0x01;
+        } else if (cmd == 0xA6 || cmd == 0xA7) {
+            Host.Inverse = cmd & 0x01;
+        } else if (cmd == 0xAE || cmd == 0xAF) {
+            Host.DisplayOn = cmd & 0x01;
+        } else if (cmd == 0xC0 || cmd == 0xC8) {
+            Host.ComRemap = (cmd == 0xC8);
+        }
+        // Scrolling, charge pump and timing settings do not change the RAM picture
+        break;
+    }
+}
+
+void ssd1306_HostCommand(const uint8_t* cmds, size_t count) {
+    Host.Bus.Transactions++;
+    Host.Bus.CommandBytes += count;
+
+    for (size_t i = 0; i < count; i++) {
+        if (Host.ArgsNeeded) {
+            Host.Args[Host.ArgCount++] = cmds[i];
+            if (Host.ArgCount == Host.ArgsNeeded) {
+                Host.ArgsNeeded = 0;
+                ssd1306_HostExecute(Host.Command, Host.Args);
+            }
+            continue;
+        }
+
+        Host.Command = cmds[i];
+        Host.ArgCount = 0;
+        Host.ArgsNeeded = ssd1306_HostArgCount(cmds[i]);
+        if (!Host.ArgsNeeded) {
+            ssd1306_HostExecute(Host.Command, Host.Args);
+        }
+    }
+}
+
+void ssd1306_HostData(const uint8_t* data, size_t count) {
+    Host.Bus.Transactions++;
+    Host.Bus.DataBytes += count;
+
+    for (size_t i = 0; i < count; i++) {
+        Host.Ram[Host.Page][Host.Column] = data[i];
+
+        switch (Host.Mode) {
+        case 0: // Horizontal: along the window, then to the next page
+            if (Host.Column == Host.ColumnEnd) {
+                Host.Column = Host.ColumnStart;
+                Host.Page = (Host.Page == Host.PageEnd) ? Host.PageStart : Host.Page + 1;
+            } else {
+                Host.Column = (Host.Column + 1) % HOST_COLUMNS;
+            }
+            break;
+        case 1: // Vertical: down the window, then to the next column
+            if (Host.Page == Host.PageEnd) {
+                Host.Page = Host.PageStart;
+                Host.Column = (Host.Column == Host.ColumnEnd) ? Host.ColumnStart : (Host.Column + 1) % HOST_COLUMNS;
+            } else {
+                Host.Page++;
+            }
+            break;
+        default: // Page: the column wraps inside the page
+            Host.Column = (Host.Column + 1) % HOST_COLUMNS;
+            break;
+        }
+    }
+}
+
+uint8_t ssd1306_HostRam(uint8_t page, uint8_t column) {
+    if (page >= HOST_PAGES || column >= HOST_COLUMNS) {
+        return 0;
+    }
+    return Host.Ram[page][column];
+}
+
+/*
+ * The glass is described in the orientation the default init (0xA1, 0xC8) gives,
+ * so an unmirrored driver shows the screenbuffer as drawn.
+ */
+uint8_t ssd1306_HostPixel(uint8_t x, uint8_t y) {
+    if (x >= SSD1306_WIDTH || y >= SSD1306_HEIGHT || !Host.DisplayOn) {
+        return 0;
+    }
+    if (Host.EntireOn) {
+        return 1;
+    }
+
+    uint32_t column = Host.SegmentRemap ? x : (SSD1306_WIDTH - 1 - x);
+    uint32_t row = Host.ComRemap ? y : (SSD1306_HEIGHT - 1 - y);
+    column += (SSD1306_X_OFFSET_UPPER << 4) | SSD1306_X_OFFSET_LOWER;
+    row = (row + Host.StartLine + Host.Offset) % HOST_ROWS;
+    if (column >= HOST_COLUMNS) {
+        return 0;
+    }
+
+    uint8_t lit = (Host.Ram[row / 8][column] >> (row % 8)) & 0x01;
+    return lit ^ Host.Inverse;
+}
+
+int ssd1306_HostWritePBM(const char* path) {
+    FILE* f = fopen(path, "wb");
+    if (f == NULL) {
+        return -1;
+    }
+
+    fprintf(f, "P4\n%d %d\n", SSD1306_WIDTH, SSD1306_HEIGHT);
+    for (uint8_t y = 0; y < SSD1306_HEIGHT; y++) {
+        uint8_t row[(SSD1306_WIDTH + 7) / 8] = {0};
+        for (uint8_t x = 0; x < SSD1306_WIDTH; x++) {
+            if (ssd1306_HostPixel(x, y)) {
+                row[x / 8] |= 0x80 >> (x % 8);
+            }
+        }
+        fwrite(row, 1, sizeof(row), f);
+    }
+    return fclose(f) == 0 ? 0 : -1;
+}
+
+int ssd1306_HostWritePGM(const char* path, uint8_t scale) {
+    FILE* f = fopen(path, "wb");
+    if (f == NULL) {
+        return -1;
+    }
+    if (scale == 0) {
+        scale = 1;
+    }
+
+    fprintf(f, "P5\n%d %d\n255\n", SSD1306_WIDTH * scale, SSD1306_HEIGHT * scale);
+    for (uint32_t y = 0; y < (uint32_t)SSD1306_HEIGHT * scale; y++) {
+        for (uint32_t x = 0; x < (uint32_t)SSD1306_WIDTH * scale; x++) {
+            fputc(ssd1306_HostPixel(x / scale, y / scale) ? 0xFF : 0x00, f);
+        }
+    }
+    return fclose(f) == 0 ? 0 : -1;
+}
+
+/* Transports of the host build */
+static void ssd1306_HostBegin(void) {
+    ssd1306_HostPowerOn();
+}
+
+// Transfer started by the asynchronous transport, applied by ssd1306_HostCompleteTransfer()
+static struct {
+    uint8_t Active;
+    uint8_t IsData;
+    const uint8_t* Buffer;
+    size_t Count;
+} HostPending;
+
+static SSD1306_Error_t ssd1306_HostWriteAsync(uint8_t is_data, const uint8_t* buffer, size_t count) {
+    if (HostPending.Active) {
+        return SSD1306_ERR;
+    }
+    HostPending.Active = 1;
+    HostPending.IsData = is_data;
+    HostPending.Buffer = buffer;
+    HostPending.Count = count;
+    return SSD1306_OK;
+}
+
+uint8_t ssd1306_HostCompleteTransfer(void) {
+    if (!HostPending.Active) {
+        return 0;
+    }
+    HostPending.Active = 0;
+    if (HostPending.IsData) {
+        ssd1306_HostData(HostPending.Buffer, HostPending.Count);
+    } else {
+        ssd1306_HostCommand(HostPending.Buffer, HostPending.Count);
+    }
+    ssd1306_FlushCpltCallback();
+    return 1;
+}
+
+void ssd1306_HostFailTransfer(void) {
+    if (!HostPending.Active) {
+        return;
+    }
+    HostPending.Active = 0;
+    ssd1306_FlushErrorCallback();
+}
+
+// Completes each transfer before returning, like a DMA interrupt that fires right away
+static SSD1306_Error_t ssd1306_HostWriteInline(uint8_t is_data, const uint8_t* buffer, size_t count) {
+    if (is_data) {
+        ssd1306_HostData(buffer, count);
+    } else {
+        ssd1306_HostCommand(buffer, count);
+    }
+    ssd1306_FlushCpltCallback();
+    return SSD1306_OK;
+}
+
+const SSD1306_Transport_t SSD1306_TransportHost = {
+    ssd1306_HostBegin, ssd1306_HostCommand, ssd1306_HostData, NULL, NULL
+};
+
+const SSD1306_Transport_t SSD1306_TransportHostAsync = {
+    ssd1306_HostBegin, ssd1306_HostCommand, ssd1306_HostData, ssd1306_HostWriteAsync, NULL
+};
+
+const SSD1306_Transport_t SSD1306_TransportHostInline = {
+    ssd1306_HostBegin, ssd1306_HostCommand, ssd1306_HostData, ssd1306_HostWriteInline, NULL
+};
+
+void ssd1306_HostGetBus(SSD1306_HostBus_t* bus) {
+    *bus = Host.Bus;
+}
+
+void ssd1306_HostResetBus(void) {
+    memset(&Host.Bus, 0, sizeof(Host.Bus));
+}
+
+#endif // SSD1306_HOST
@@ -0,0 +1,117 @@
+/**
+ * Linux build of the SSD1306 library.
+ *
+ * Compile the driver with -DSSD1306_HOST and link ssd1306_host.c instead of the HAL:
+ *
+ *   gcc -DSSD1306_HOST -IDrivers/ssd1306 Drivers/ssd1306/ssd1306.c Drivers/ssd1306/ssd1306_host.c \
+ *       Drivers/ssd1306/ssd1306_fonts_subset.c my_test.c -lm
+ *
+ * Commands and data then go to an emulated controller that keeps its own GDDRAM,
+ * addressing state and display settings. The picture it shows can be written to
+ * PBM/PGM files for golden-image comparisons, and the bus bytes are counted.
+ * SSD1306_TransportHost (the default) blocks. With SSD1306_TransportHostAsync,
+ * selected through ssd1306_InitTransport(), transfers stay pending until
+ * ssd1306_HostCompleteTransfer() plays the role of the DMA interrupt.
+ * SSD1306_TransportHostInline completes every transfer, callback included,
+ * before WriteAsync returns: the earliest a real interrupt can fire.
+ */
+
+#ifndef __SSD1306_HOST_H__
+#define __SSD1306_HOST_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+// newlib's <_ansi.h> is not available on the host
+#ifndef _BEGIN_STD_C
+#ifdef __cplusplus
+#define _BEGIN_STD_C extern "C" {
+#define _END_STD_C }
+#else
+#define _BEGIN_STD_C
+#define _END_STD_C
+#endif
+#endif
+
+_BEGIN_STD_C
+
+// The HAL pieces the driver uses, backed by the host clock
+#define HAL_MAX_DELAY      0xFFFFFFFFU
+uint32_t HAL_GetTick(void);
+void HAL_Delay(uint32_t delay);
+
+/**
+ * @brief Replaces the host clock with a manual one, for reproducible runs:
+ *        HAL_GetTick() returns ms until the next call and HAL_Delay() advances it.
+ */
+void ssd1306_HostSetTick(uint32_t ms);
+
+// Bytes seen by the emulated controller
+typedef struct {
+    uint32_t CommandBytes;
+    uint32_t DataBytes;
+    uint32_t Transactions;      // Command or data writes; on I2C each adds an address and a control byte
+} SSD1306_HostBus_t;
+
+/**
+ * @brief Puts the emulated controller in its power-on state: RAM cleared,
+ *        page addressing, display off. ssd1306_Reset() calls it.
+ */
+void ssd1306_HostPowerOn(void);
+
+/**
+ * @brief Feed the emulated controller, one call per bus transaction.
+ */
+void ssd1306_HostCommand(const uint8_t* cmds, size_t count);
+void ssd1306_HostData(const uint8_t* data, size_t count);
+
+/**
+ * @brief Completes the transfer started by SSD1306_TransportHostAsync and
+ *        calls ssd1306_FlushCpltCallback(), which may start the next one.
+ * @note Repeat until it returns 0 to finish a flush. A blocking driver call
+ *       made while a flush is pending would wait forever on the host.
+ * @return 1 when a transfer was completed, 0 when none was pending.
+ */
+uint8_t ssd1306_HostCompleteTransfer(void);
+
+/**
+ * @brief Drops the transfer started by SSD1306_TransportHostAsync without
+ *        applying it and calls ssd1306_FlushErrorCallback(), like a bus error.
+ */
+void ssd1306_HostFailTransfer(void);
+
+/**
+ * @brief Reads a byte of the controller RAM.
+ * @param column RAM column, SSD1306_X_OFFSET included.
+ */
+uint8_t ssd1306_HostRam(uint8_t page, uint8_t column);
+
+/**
+ * @brief Reads what the panel shows at (x, y), after display on/off, inversion,
+ *        entire display on, remapping, start line and display offset.
+ * @return 1 when the pixel is lit.
+ */
+uint8_t ssd1306_HostPixel(uint8_t x, uint8_t y);
+
+/**
+ * @brief Writes the panel picture as a binary PBM (P4), lit pixels black on white paper.
+ * @return 0 on success, -1 when the file cannot be written.
+ */
+int ssd1306_HostWritePBM(const char* path);
+
+/**
+ * @brief Writes the panel picture as a binary PGM (P5), lit pixels white.
+ * @param scale Size of each panel pixel in image pixels, 0 or 1 for one to one.
+ * @return 0 on success, -1 when the file cannot be written.
+ */
+int ssd1306_HostWritePGM(const char* path, uint8_t scale);
+
+/**
+ * @brief Reads and clears the bus counters, e.g. around one ssd1306_UpdateScreen().
+ */
+void ssd1306_HostGetBus(SSD1306_HostBus_t* bus);
+void ssd1306_HostResetBus(void);
+
+_END_STD_C
+
+#endif // __SSD1306_HOST_H__
@@ -4,6 +4,10 @@
 #include "ssd1306_tests.h"
 #include "ssd1306_fonts.h"
 
+#ifdef SSD1306_HOST
+#include <time.h>
+#endif
+
 //------------------------------------------------------------------------------
 // Table generated by LCD Assistant
 // http://en.radzio.dxp.pl/bitmap_converter/
@@ -252,6 +256,291 @@ void ssd1306_TestFPS() {
     ssd1306_UpdateScreen();
 }
 
+// Unit of ssd1306_TestCycles()
+#if defined(SSD1306_HOST)
+#define SSD1306_TEST_UNIT "ns"
+#else
+#define SSD1306_TEST_UNIT "cycles"
+#endif
+
+/* CPU cycles, from the DWT cycle counter when the core has one. Nanoseconds on the host. */
+static uint32_t ssd1306_TestCycles() {
+#if defined(SSD1306_HOST)
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint32_t)(now.tv_sec * 1000000000ull + now.tv_nsec);
+#elif defined(DWT_CTRL_CYCCNTENA_Msk)
+    if (!(DWT->CTRL & DWT_CTRL_CYCCNTENA_Msk)) {
+        CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+        DWT->CYCCNT = 0;
+        DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+    }
+    return DWT->CYCCNT;
+#else
+    return HAL_GetTick() * (SystemCoreClock / 1000);
+#endif
+}
+
+/*
+ * Compares the page layout glyph blitter with the per-pixel renderer.
+ * Both draw the same characters on page aligned and unaligned rows,
+ * the result is shown in cycles per character.
+ */
+void ssd1306_TestFontBlit() {
+// Subset fonts carry no uint16_t rows to compare against
+#if defined(SSD1306_INCLUDE_FONT_11x18) && !defined(SSD1306_USE_FONT_SUBSET)
+    const SSD1306_Font_t rows = {Font_11x18.width, Font_11x18.height, Font_11x18.data, Font_11x18.char_width, NULL};
+    const SSD1306_Font_t* fonts[2] = {&rows, &Font_11x18};
+    const uint32_t chars = 200;
+    uint32_t cycles[2];
+    char buff[32];
+
+    for (uint8_t f = 0; f < 2; f++) {
+        ssd1306_Fill(Black);
+        uint32_t start = ssd1306_TestCycles();
+        for (uint32_t i = 0; i < chars; i++) {
+            // Alternate between y = 0 (page aligned) and y = 3 (spread over two more pages)
+            ssd1306_SetCursor((i % 11) * 11, (i & 1) ? 3 : 0);
+            ssd1306_WriteChar('A' + (i % 26), *fonts[f], White);
+        }
+        cycles[f] = (ssd1306_TestCycles() - start) / chars;
+    }
+
+    ssd1306_Fill(Black);
+    ssd1306_SetCursor(2, 0);
+    ssd1306_WriteString("cyc/char", Font_11x18, White);
+    snprintf(buff, sizeof(buff), "rows %lu", (unsigned long)cycles[0]);
+    ssd1306_SetCursor(2, 20);
+    ssd1306_WriteString(buff, Font_11x18, White);
+    snprintf(buff, sizeof(buff), "page %lu", (unsigned long)cycles[1]);
+    ssd1306_SetCursor(2, 40);
+    ssd1306_WriteString(buff, Font_11x18, White);
+    ssd1306_UpdateScreen();
+#endif
+}
+
+/* Per-pixel references for ssd1306_TestSpans() */
+static void ssd1306_TestFillPixels(uint8_t x1, uint8_t y1, uint8_t x2, uint8_t y2, SSD1306_COLOR color) {
+    for (uint8_t y = y1; y <= y2; y++) {
+        for (uint8_t x = x1; x <= x2; x++) {
+            ssd1306_DrawPixel(x, y, color);
+        }
+    }
+}
+
+static void ssd1306_TestCirclePixels(uint8_t cx, uint8_t cy, uint8_t r, SSD1306_COLOR color) {
+    for (int32_t dy = -r; dy <= r; dy++) {
+        for (int32_t dx = -r; dx <= r; dx++) {
+            if (dx * dx + dy * dy <= r * r) {
+                ssd1306_DrawPixel(cx + dx, cy + dy, color);
+            }
+        }
+    }
+}
+
+/*
+ * Speed of the span fills against drawing the same shapes pixel by pixel:
+ * a 30x12 bar, a full width line, a full height line and a radius 20 disc.
+ */
+void ssd1306_TestSpans() {
+    const char* names[4] = {"bar", "hline", "vline", "disc"};
+    const uint32_t rounds = 50;
+    uint32_t cycles[4][2];
+    char buff[32];
+
+    for (uint8_t t = 0; t < 4; t++) {
+        for (uint8_t span = 0; span < 2; span++) {
+            uint32_t start = ssd1306_TestCycles();
+            for (uint32_t i = 0; i < rounds; i++) {
+                SSD1306_COLOR color = (i & 1) ? Black : White;
+                switch (t) {
+                case 0:
+                    if (span) ssd1306_FillRectangle(97, 39, 126, 50, color);
+                    else ssd1306_TestFillPixels(97, 39, 126, 50, color);
+                    break;
+                case 1:
+                    if (span) ssd1306_Line(0, 33, SSD1306_WIDTH - 1, 33, color);
+                    else ssd1306_TestFillPixels(0, 33, SSD1306_WIDTH - 1, 33, color);
+                    break;
+                case 2:
+                    if (span) ssd1306_Line(64, 0, 64, SSD1306_HEIGHT - 1, color);
+                    else ssd1306_TestFillPixels(64, 0, 64, SSD1306_HEIGHT - 1, color);
+                    break;
+                default:
+                    if (span) ssd1306_FillCircle(64, 32, 20, color);
+                    else ssd1306_TestCirclePixels(64, 32, 20, color);
+                    break;
+                }
+            }
+            cycles[t][span] = (ssd1306_TestCycles() - start) / rounds;
+        }
+    }
+
+    // One line per shape, cycles per call of the pixel version over the span version
+    ssd1306_Fill(Black);
+    for (uint8_t t = 0; t < 4; t++) {
+        uint32_t speedup = cycles[t][1] ? cycles[t][0] / cycles[t][1] : 0;
+        snprintf(buff, sizeof(buff), "%s x%lu", names[t], (unsigned long)speedup);
+        ssd1306_SetCursor(2, t * 16);
+        ssd1306_WriteString(buff, Font_11x18, White);
+    }
+    ssd1306_UpdateScreen();
+}
+
+/* Primitives timed by ssd1306_TestBenchmark(), i is the call number */
+static SSD1306_COLOR ssd1306_BenchColor(uint32_t i) {
+    return (i & 1) ? Black : White;
+}
+
+static void ssd1306_BenchFill(uint32_t i) {
+    ssd1306_Fill(ssd1306_BenchColor(i));
+}
+
+static void ssd1306_BenchLine(uint32_t i) {
+    ssd1306_Line(0, 0, SSD1306_WIDTH - 1, SSD1306_HEIGHT - 1, ssd1306_BenchColor(i));
+}
+
+static void ssd1306_BenchHLine(uint32_t i) {
+    ssd1306_Line(0, SSD1306_HEIGHT / 2, SSD1306_WIDTH - 1, SSD1306_HEIGHT / 2, ssd1306_BenchColor(i));
+}
+
+static void ssd1306_BenchCircle(uint32_t i) {
+    ssd1306_DrawCircle(SSD1306_WIDTH / 2, SSD1306_HEIGHT / 2, 20, ssd1306_BenchColor(i));
+}
+
+static void ssd1306_BenchFillCircle(uint32_t i) {
+    ssd1306_FillCircle(SSD1306_WIDTH / 2, SSD1306_HEIGHT / 2, 20, ssd1306_BenchColor(i));
+}
+
+static void ssd1306_BenchFillRectangle(uint32_t i) {
+    ssd1306_FillRectangle(10, 10, SSD1306_WIDTH - 11, SSD1306_HEIGHT - 11, ssd1306_BenchColor(i));
+}
+
+static void ssd1306_BenchBitmap(uint32_t i) {
+    ssd1306_DrawBitmap(0, 0, garfield_128x64, 128, 64, ssd1306_BenchColor(i));
+}
+
+// One character per call, alternating page aligned and unaligned rows
+#define SSD1306_BENCH_FONT(font) \
+static void ssd1306_BenchChar_##font(uint32_t i) { \
+    ssd1306_SetCursor((i % 8) * font.width, (i & 1) ? 3 : 0); \
+    ssd1306_WriteChar('0' + (i % 10), font, White); \
+}
+
+#ifdef SSD1306_INCLUDE_FONT_6x8
+SSD1306_BENCH_FONT(Font_6x8)
+#endif
+#ifdef SSD1306_INCLUDE_FONT_7x10
+SSD1306_BENCH_FONT(Font_7x10)
+#endif
+#ifdef SSD1306_INCLUDE_FONT_11x18
+SSD1306_BENCH_FONT(Font_11x18)
+#endif
+#ifdef SSD1306_INCLUDE_FONT_16x26
+SSD1306_BENCH_FONT(Font_16x26)
+#endif
+#ifdef SSD1306_INCLUDE_FONT_16x24
+SSD1306_BENCH_FONT(Font_16x24)
+#endif
+#ifdef SSD1306_INCLUDE_FONT_16x15
+SSD1306_BENCH_FONT(Font_16x15)
+#endif
+
+typedef struct {
+    const char* name;
+    void (*draw)(uint32_t i);
+    uint32_t calls;
+    uint8_t flush;      // Time the flush after draw instead of draw itself
+} SSD1306_BenchCase_t;
+
+static const SSD1306_BenchCase_t ssd1306_BenchCases[] = {
+    {"fill",            ssd1306_BenchFill,          20, 0},
+#ifdef SSD1306_INCLUDE_FONT_6x8
+    {"char_6x8",        ssd1306_BenchChar_Font_6x8,   200, 0},
+#endif
+#ifdef SSD1306_INCLUDE_FONT_7x10
+    {"char_7x10",       ssd1306_BenchChar_Font_7x10,  200, 0},
+#endif
+#ifdef SSD1306_INCLUDE_FONT_11x18
+    {"char_11x18",      ssd1306_BenchChar_Font_11x18, 200, 0},
+#endif
+#ifdef SSD1306_INCLUDE_FONT_16x26
+    {"char_16x26",      ssd1306_BenchChar_Font_16x26, 200, 0},
+#endif
+#ifdef SSD1306_INCLUDE_FONT_16x24
+    {"char_16x24",      ssd1306_BenchChar_Font_16x24, 200, 0},
+#endif
+#ifdef SSD1306_INCLUDE_FONT_16x15
+    {"char_16x15",      ssd1306_BenchChar_Font_16x15, 200, 0},
+#endif
+    {"line_diagonal",   ssd1306_BenchLine,          100, 0},
+    {"line_horizontal", ssd1306_BenchHLine,         100, 0},
+    {"circle",          ssd1306_BenchCircle,        100, 0},
+    {"fill_circle",     ssd1306_BenchFillCircle,    100, 0},
+    {"fill_rectangle",  ssd1306_BenchFillRectangle, 100, 0},
+    {"bitmap",          ssd1306_BenchBitmap,        20,  0},
+    {"update_full",     ssd1306_BenchFill,          10,  1},
+    {"update_circle",   ssd1306_BenchFillCircle,    10,  1},
+};
+
+/*
+ * Times every primitive and prints one CSV row per primitive:
+ * name, calls, time per call, and the data bytes flushed for one call on a blank
+ * panel (for the update_ rows, the average bytes of the timed flushes themselves).
+ * Time is in CPU cycles on target and nanoseconds in the host build.
+ * Leaves the screen cleared.
+ */
+void ssd1306_TestBenchmark(void (*print)(const char* line)) {
+    char line[64];
+
+    print("# ssd1306 benchmark, time in " SSD1306_TEST_UNIT "\r\n");
+    print("name,calls,time_per_call,bytes\r\n");
+
+    for (uint32_t c = 0; c < sizeof(ssd1306_BenchCases) / sizeof(ssd1306_BenchCases[0]); c++) {
+        const SSD1306_BenchCase_t* bench = &ssd1306_BenchCases[c];
+        SSD1306_FlushStats_t stats;
+        uint32_t elapsed = 0;
+        uint32_t bytes = 0;
+
+        // Start from a blank panel in sync with the screenbuffer
+        ssd1306_Fill(Black);
+        ssd1306_UpdateScreen();
+
+        if (bench->flush) {
+            for (uint32_t i = 0; i < bench->calls; i++) {
+                bench->draw(i);
+                uint32_t start = ssd1306_TestCycles();
+                ssd1306_UpdateScreen();
+                elapsed += ssd1306_TestCycles() - start;
+                ssd1306_GetFlushStats(&stats);
+                bytes += stats.LastBytesSent;
+            }
+            bytes /= bench->calls;
+        } else {
+            uint32_t start = ssd1306_TestCycles();
+            for (uint32_t i = 0; i < bench->calls; i++) {
+                bench->draw(i);
+            }
+            elapsed = ssd1306_TestCycles() - start;
+
+            // Bus cost of a single call drawn on the blank panel
+            ssd1306_Fill(Black);
+            ssd1306_UpdateScreen();
+            bench->draw(0);
+            ssd1306_UpdateScreen();
+            ssd1306_GetFlushStats(&stats);
+            bytes = stats.LastBytesSent;
+        }
+
+        snprintf(line, sizeof(line), "%s,%lu,%lu,%lu\r\n", bench->name, (unsigned long)bench->calls,
+                 (unsigned long)(elapsed / bench->calls), (unsigned long)bytes);
+        print(line);
+    }
+
+    ssd1306_Fill(Black);
+    ssd1306_UpdateScreen();
+}
+
 void ssd1306_TestLine() {
 
   ssd1306_Line(1,1,SSD1306_WIDTH - 1,SSD1306_HEIGHT - 1,White);
@@ -361,6 +650,10 @@ void ssd1306_TestAll() {
 
     ssd1306_TestFPS();
     HAL_Delay(3000);
+    ssd1306_TestFontBlit();
+    HAL_Delay(3000);
+    ssd1306_TestSpans();
+    HAL_Delay(3000);
     ssd1306_TestBorder();
     ssd1306_TestFonts1();
     HAL_Delay(3000);
@@ -1,7 +1,7 @@
 #ifndef __SSD1306_TEST_H__
 #define __SSD1306_TEST_H__
 
-#include <_ansi.h>
+#include "ssd1306.h"
 
 _BEGIN_STD_C
 
@@ -9,6 +9,9 @@ void ssd1306_TestBorder(void);
 void ssd1306_TestFonts1(void);
 void ssd1306_TestFonts2(void);
 void ssd1306_TestFPS(void);
+void ssd1306_TestFontBlit(void);
+void ssd1306_TestSpans(void);
+void ssd1306_TestBenchmark(void (*print)(const char* line));
 void ssd1306_TestAll(void);
 void ssd1306_TestLine(void);
 void ssd1306_TestRectangle(void);
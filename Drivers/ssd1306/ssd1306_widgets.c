@@ -0,0 +1,145 @@
+#include "ssd1306_widgets.h"
+#include <stdio.h>
+#include <string.h>
+
+static void ssd1306_WidgetReset(SSD1306_Widget_t *w, SSD1306_WidgetType_t type, uint8_t x, uint8_t y) {
+    memset(w, 0, sizeof(*w));
+    w->Type = type;
+    w->X = x;
+    w->Y = y;
+    w->Color = White;
+}
+
+void ssd1306_WidgetLabel(SSD1306_Widget_t *w, uint8_t x, uint8_t y, const SSD1306_Font_t *font,
+                         uint8_t cells, const char *text) {
+    ssd1306_WidgetReset(w, SSD1306_WIDGET_LABEL, x, y);
+    w->Font = font;
+    w->Cells = (cells > SSD1306_WIDGET_MAX_CELLS) ? SSD1306_WIDGET_MAX_CELLS : cells;
+    w->Text = text;
+}
+
+void ssd1306_WidgetNumber(SSD1306_Widget_t *w, uint8_t x, uint8_t y, const SSD1306_Font_t *font,
+                          uint8_t cells, const char *format, SSD1306_WidgetValue_t value, const void *ctx) {
+    ssd1306_WidgetLabel(w, x, y, font, cells, NULL);
+    w->Type = SSD1306_WIDGET_NUMBER;
+    w->Format = format;
+    w->Value = value;
+    w->Context = ctx;
+}
+
+void ssd1306_WidgetBar(SSD1306_Widget_t *w, uint8_t x, uint8_t y, uint8_t width, uint8_t height,
+                       int32_t min, int32_t max, SSD1306_WidgetValue_t value, const void *ctx) {
+    ssd1306_WidgetReset(w, SSD1306_WIDGET_BAR, x, y);
+    w->Width = width;
+    w->Height = height;
+    w->Min = min;
+    w->Max = (max > min) ? max : min + 1;
+    w->Value = value;
+    w->Context = ctx;
+}
+
+void ssd1306_WidgetInvalidate(SSD1306_Widget_t *w) {
+    w->Valid = 0;
+}
+
+/* Redraw the cells whose character differs from the one on screen */
+static uint8_t ssd1306_WidgetDrawText(SSD1306_Widget_t *w, const char *text) {
+    uint8_t redrawn = 0;
+    uint8_t end = 0;
+
+    for (uint8_t i = 0; i < w->Cells; i++) {
+        // Past the end of the text the cell shows a space
+        if (!end && text[i] == '\0') {
+            end = 1;
+        }
+        const char ch = end ? ' ' : text[i];
+
+        if (w->Valid && w->Shown[i] == ch) {
+            continue;
+        }
+        ssd1306_SetCursor(w->X + i * w->Font->width, w->Y);
+        ssd1306_WriteChar(ch, *w->Font, w->Color);
+        w->Shown[i] = ch;
+        redrawn++;
+    }
+    return redrawn;
+}
+
+/* Filled columns of the bar interior for a value */
+static uint8_t ssd1306_WidgetBarFill(const SSD1306_Widget_t *w, int32_t value) {
+    const int32_t inner = w->Width - 2;
+    if (value <= w->Min) return 0;
+    if (value >= w->Max) return inner;
+    return (uint8_t)((value - w->Min) * inner / (w->Max - w->Min));
+}
+
+static uint8_t ssd1306_WidgetDrawBar(SSD1306_Widget_t *w, int32_t value) {
+    const uint8_t x = w->X + 1;
+    const uint8_t y1 = w->Y + 1;
+    const uint8_t y2 = w->Y + w->Height - 2;
+    const uint8_t fill = ssd1306_WidgetBarFill(w, value);
+    const SSD1306_COLOR back = (SSD1306_COLOR)!w->Color;
+
+    if (w->Width < 3 || w->Height < 3) {
+        return 0;
+    }
+
+    if (!w->Valid) {
+        // Frame and both parts of the interior
+        ssd1306_DrawRectangle(w->X, w->Y, w->X + w->Width - 1, w->Y + w->Height - 1, w->Color);
+        if (fill > 0) {
+            ssd1306_FillRectangle(x, y1, x + fill - 1, y2, w->Color);
+        }
+        if (fill < w->Width - 2) {
+            ssd1306_FillRectangle(x + fill, y1, w->X + w->Width - 2, y2, back);
+        }
+        return w->Width;
+    }
+
+    // Only the columns between the old and the new fill level change
+    const uint8_t old = ssd1306_WidgetBarFill(w, w->Last);
+    if (fill > old) {
+        ssd1306_FillRectangle(x + old, y1, x + fill - 1, y2, w->Color);
+        return fill - old;
+    }
+    if (fill < old) {
+        ssd1306_FillRectangle(x + fill, y1, x + old - 1, y2, back);
+        return old - fill;
+    }
+    return 0;
+}
+
+uint8_t ssd1306_WidgetUpdate(SSD1306_Widget_t *w) {
+    uint8_t redrawn = 0;
+
+    switch (w->Type) {
+    case SSD1306_WIDGET_LABEL:
+        redrawn = ssd1306_WidgetDrawText(w, w->Text ? w->Text : "");
+        break;
+
+    case SSD1306_WIDGET_NUMBER: {
+        const int32_t value = w->Value(w->Context);
+        if (w->Valid && value == w->Last) {
+            return 0;
+        }
+        char text[SSD1306_WIDGET_MAX_CELLS + 1];
+        snprintf(text, sizeof(text), w->Format, (long)value);
+        redrawn = ssd1306_WidgetDrawText(w, text);
+        w->Last = value;
+        break;
+    }
+
+    case SSD1306_WIDGET_BAR: {
+        const int32_t value = w->Value(w->Context);
+        if (w->Valid && value == w->Last) {
+            return 0;
+        }
+        redrawn = ssd1306_WidgetDrawBar(w, value);
+        w->Last = value;
+        break;
+    }
+    }
+
+    w->Valid = 1;
+    return redrawn;
+}
@@ -0,0 +1,78 @@
+#ifndef __SSD1306_WIDGETS_H__
+#define __SSD1306_WIDGETS_H__
+
+#include "ssd1306.h"
+
+_BEGIN_STD_C
+
+// Longest text a label or number widget can hold
+#define SSD1306_WIDGET_MAX_CELLS  16
+
+typedef enum {
+    SSD1306_WIDGET_LABEL,   // Bound string, one glyph cell per character
+    SSD1306_WIDGET_NUMBER,  // Bound value printed with a format
+    SSD1306_WIDGET_BAR      // Bound value as a horizontal bar with a frame
+} SSD1306_WidgetType_t;
+
+/** Reads the bound value, ctx is the widget Context (e.g. the owning structure) */
+typedef int32_t (*SSD1306_WidgetValue_t)(const void *ctx);
+
+/**
+ * Retained-mode widget. The configuration fields are set by the init functions,
+ * the state fields remember what is on screen so updates only redraw what changed.
+ */
+typedef struct {
+    SSD1306_WidgetType_t Type;
+    uint8_t X;                      // Top-left corner
+    uint8_t Y;
+    SSD1306_COLOR Color;            // Foreground, White unless changed after init
+    const SSD1306_Font_t *Font;     // Label and number, must be monospaced
+    uint8_t Cells;                  // Label and number: glyph cells reserved
+    uint8_t Width;                  // Bar size in pixels, frame included
+    uint8_t Height;
+    const char *Text;               // Label: bound string
+    const char *Format;             // Number: printf format taking a long
+    SSD1306_WidgetValue_t Value;    // Number and bar: bound value
+    const void *Context;
+    int32_t Min;                    // Bar: value range
+    int32_t Max;
+
+    uint8_t Valid;                  // State: 0 until the widget is drawn once
+    int32_t Last;                   // Last value drawn (number and bar)
+    char Shown[SSD1306_WIDGET_MAX_CELLS];
+} SSD1306_Widget_t;
+
+/**
+ * @brief Sets up a label showing a string kept up to date by its owner.
+ * @param cells Glyph cells to reserve, shorter text is padded with spaces.
+ */
+void ssd1306_WidgetLabel(SSD1306_Widget_t *w, uint8_t x, uint8_t y, const SSD1306_Font_t *font,
+                         uint8_t cells, const char *text);
+
+/**
+ * @brief Sets up a number printed with format (e.g. "%ld C") from value(ctx).
+ */
+void ssd1306_WidgetNumber(SSD1306_Widget_t *w, uint8_t x, uint8_t y, const SSD1306_Font_t *font,
+                          uint8_t cells, const char *format, SSD1306_WidgetValue_t value, const void *ctx);
+
+/**
+ * @brief Sets up a bar filled in proportion to value(ctx) between min and max.
+ */
+void ssd1306_WidgetBar(SSD1306_Widget_t *w, uint8_t x, uint8_t y, uint8_t width, uint8_t height,
+                       int32_t min, int32_t max, SSD1306_WidgetValue_t value, const void *ctx);
+
+/**
+ * @brief Redraws the parts of the widget whose bound data changed since the last update.
+ * @return Number of glyph cells or bar columns redrawn, 0 when nothing changed.
+ * @note Moves the text cursor.
+ */
+uint8_t ssd1306_WidgetUpdate(SSD1306_Widget_t *w);
+
+/**
+ * @brief Forces the next update to redraw the whole widget, e.g. after ssd1306_LoadScreen().
+ */
+void ssd1306_WidgetInvalidate(SSD1306_Widget_t *w);
+
+_END_STD_C
+
+#endif // __SSD1306_WIDGETS_H__
@@ -0,0 +1,175 @@
+#!/usr/bin/env python3
+"""
+Glyph-subset font packer for the SSD1306 driver.
+
+Keeps only the fonts and characters listed in font_charset.txt and writes
+them to ssd1306_fonts_subset.c, which replaces the full tables of
+ssd1306_fonts.c when SSD1306_USE_FONT_SUBSET is defined in ssd1306_conf.h.
+
+For every font it emits:
+  - an index table mapping characters 32..126 to a glyph slot
+    (SSD1306_GLYPH_NONE when the character was left out), so lookup stays O(1);
+  - with --format rows, the rows packed at their real bit width: `width`
+    bits per row, MSB first, each glyph padded to a whole byte (smallest);
+  - with --format pages, the page layout used by the byte blitter
+    (see font_pages.py, fastest). This is the default.
+
+Usage:
+    python font_pack.py [--format rows|pages|both] [charset.txt] [ssd1306_fonts.c] [output.c]
+"""
+
+import argparse
+import os
+import re
+import sys
+
+from font_pages import FIRST_CHAR, parse_fonts, glyph_to_pages
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+DEFAULT_CHARSET = os.path.join(HERE, "font_charset.txt")
+DEFAULT_SRC = os.path.join(HERE, "..", "ssd1306_fonts.c")
+DEFAULT_DST = os.path.join(HERE, "..", "ssd1306_fonts_subset.c")
+
+GLYPH_COUNT = 95
+GLYPH_NONE = 0xFF
+
+# "static const uint8_t char_width[] = { ... };" of the proportional font
+CHAR_WIDTH_RE = re.compile(
+    r"#ifdef\s+(SSD1306_INCLUDE_FONT_\d+x\d+)(?:(?!#endif).)*?"
+    r"static\s+const\s+uint8_t\s+char_width\s*\[\]\s*=\s*\{(.*?)\};",
+    re.S)
+
+
+def parse_charset(path):
+    """Returns {"11x18": "chars", ...}, the space is always part of the set"""
+    sets = {}
+    with open(path) as f:
+        for line in f:
+            line = line.rstrip("\n")
+            if not line.strip() or line.lstrip().startswith("#"):
+                continue
+            size, _, chars = line.partition(":")
+            chars = chars.lstrip(" ")
+            bad = [c for c in chars if not FIRST_CHAR <= ord(c) < FIRST_CHAR + GLYPH_COUNT]
+            if bad:
+                raise ValueError(f"{size}: characters outside 32..126: {bad!r}")
+            sets[size.strip()] = sorted(set(" " + chars))
+    return sets
+
+
+def parse_char_widths(source):
+    """Returns {guard: [width of each glyph]} for proportional fonts"""
+    widths = {}
+    for m in CHAR_WIDTH_RE.finditer(source):
+        body = re.sub(r"/\*.*?\*/", "", m.group(2), flags=re.S)
+        widths[m.group(1)] = [int(v, 0) for v in body.split(",") if v.strip()]
+    return widths
+
+
+def pack_rows(rows, width):
+    """Packs the rows of one glyph into a bitstream of `width` bits per row"""
+    bits = []
+    for row in rows:
+        bits.extend(1 if (row << col) & 0x8000 else 0 for col in range(width))
+    bits.extend([0] * (-len(bits) % 8))
+    return [int("".join(map(str, bits[i:i + 8])), 2) for i in range(0, len(bits), 8)]
+
+
+def label(ch):
+    # A trailing backslash would continue the // comment onto the next line
+    return {" ": "sp", "\\": "backslash"}.get(ch, ch)
+
+
+def hex_lines(values, per_line=16):
+    return [", ".join(f"0x{v:02X}" for v in values[i:i + per_line]) + ","
+            for i in range(0, len(values), per_line)]
+
+
+def emit_font(out, guard, name, width, height, rows, chars, char_width, fmt):
+    size = f"{width}x{height}"
+    slots = {ch: i for i, ch in enumerate(chars)}
+    index = [slots.get(chr(FIRST_CHAR + g), GLYPH_NONE) for g in range(GLYPH_COUNT)]
+    glyph_rows = [rows[(ord(ch) - FIRST_CHAR) * height:(ord(ch) - FIRST_CHAR + 1) * height] for ch in chars]
+    flash = len(index)
+
+    out.append(f"#ifdef {guard}")
+    out.append(f"// {size}: {len(chars)} of {GLYPH_COUNT} glyphs")
+    out.append(f"static const uint8_t {name}_index [] = {{")
+    out.extend(hex_lines(index))
+    out.append("};")
+
+    packed = "NULL"
+    if fmt in ("rows", "both"):
+        packed = f"{name}_packed"
+        out.append(f"static const uint8_t {packed} [] = {{")
+        for ch, g in zip(chars, glyph_rows):
+            data = pack_rows(g, width)
+            flash += len(data)
+            out.append(", ".join(f"0x{b:02X}" for b in data) + f",  // {label(ch)}")
+        out.append("};")
+
+    pages = "NULL"
+    if fmt in ("pages", "both"):
+        pages = f"{name}_pages"
+        out.append(f"static const uint8_t {pages} [] = {{")
+        for ch, g in zip(chars, glyph_rows):
+            data = glyph_to_pages(g, width, height)
+            flash += len(data)
+            out.append(", ".join(f"0x{b:02X}" for b in data) + f",  // {label(ch)}")
+        out.append("};")
+
+    widths = "NULL"
+    if char_width:
+        widths = f"{name}_char_width"
+        out.append(f"static const uint8_t {widths} [] = {{")
+        out.extend(hex_lines([char_width[ord(ch) - FIRST_CHAR] for ch in chars]))
+        out.append("};")
+        flash += len(chars)
+
+    out.append(f"const SSD1306_Font_t Font_{size} = {{{width}, {height}, NULL, {widths}, {pages}, {name}_index, {packed}}};")
+    out.append("#endif")
+    out.append("")
+    return flash
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.splitlines()[1])
+    # The renderer prefers pages when present, so "both" only helps code that reads the rows
+    ap.add_argument("--format", choices=("rows", "pages", "both"), default="pages",
+                    help="glyph data to emit: rows is smallest, pages renders fastest (default: pages)")
+    ap.add_argument("charset", nargs="?", default=DEFAULT_CHARSET)
+    ap.add_argument("source", nargs="?", default=DEFAULT_SRC)
+    ap.add_argument("output", nargs="?", default=DEFAULT_DST)
+    args = ap.parse_args()
+
+    with open(args.source) as f:
+        source = f.read()
+    fonts = {f"{w}x{h}": (guard, name, w, h, rows) for guard, name, w, h, rows in parse_fonts(source)}
+    char_widths = parse_char_widths(source)
+    charset = parse_charset(args.charset)
+
+    out = [
+        "/*",
+        " * Glyph subsets of the fonts in ssd1306_fonts.c, see tools/font_pack.py.",
+        " * Generated from tools/font_charset.txt, do not edit.",
+        " */",
+        "",
+        "#include \"ssd1306_fonts.h\"",
+        "",
+        "#ifdef SSD1306_USE_FONT_SUBSET",
+        "",
+    ]
+    for size, chars in charset.items():
+        if size not in fonts:
+            sys.exit(f"{args.charset}: no font {size} in {args.source}")
+        guard, name, w, h, rows = fonts[size]
+        flash = emit_font(out, guard, name, w, h, rows, chars, char_widths.get(guard), args.format)
+        print(f"Font_{size}: {len(chars)} glyphs, {flash} bytes")
+    out.append("#endif // SSD1306_USE_FONT_SUBSET")
+
+    with open(args.output, "w", newline="\n") as f:
+        f.write("\n".join(out) + "\n")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,113 @@
+#!/usr/bin/env python3
+"""
+Font converter for the SSD1306 driver.
+
+Reads the row-oriented font tables of ssd1306_fonts.c (one uint16_t per
+glyph row, MSB = leftmost pixel) and writes them in the controller's
+native page layout: for every glyph, ceil(height / 8) pages of `width`
+bytes, each byte a column of 8 pixels with the LSB on top. The result is
+ssd1306_fonts_pages.h, included by ssd1306_fonts.c and used by the byte
+blitter in ssd1306_WriteChar().
+
+Usage:
+    python font_pages.py [path/to/ssd1306_fonts.c] [path/to/ssd1306_fonts_pages.h]
+
+Run it again whenever a font table in ssd1306_fonts.c changes.
+"""
+
+import os
+import re
+import sys
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+DEFAULT_SRC = os.path.join(HERE, "..", "ssd1306_fonts.c")
+DEFAULT_DST = os.path.join(HERE, "..", "ssd1306_fonts_pages.h")
+
+FIRST_CHAR = 32
+
+# "#ifdef SSD1306_INCLUDE_FONT_11x18" followed by "static const uint16_t Font11x18 [] = { ... };"
+TABLE_RE = re.compile(
+    r"#ifdef\s+(SSD1306_INCLUDE_FONT_(\d+)x(\d+))\s*"
+    r"static\s+const\s+uint16_t\s+(\w+)\s*\[\]\s*=\s*\{(.*?)\};",
+    re.S)
+
+
+def strip_comments(text):
+    text = re.sub(r"/\*.*?\*/", "", text, flags=re.S)
+    return re.sub(r"//[^\n]*", "", text)
+
+
+def parse_fonts(source):
+    """Returns (guard, name, width, height, rows) for every uint16_t font table"""
+    fonts = []
+    for m in TABLE_RE.finditer(source):
+        guard, width, height, name, body = m.groups()
+        rows = [int(v, 0) for v in strip_comments(body).replace("\n", " ").split(",") if v.strip()]
+        width, height = int(width), int(height)
+        if len(rows) % height:
+            raise ValueError(f"{name}: {len(rows)} rows is not a multiple of the height {height}")
+        fonts.append((guard, name, width, height, rows))
+    return fonts
+
+
+def glyph_to_pages(rows, width, height):
+    """Converts one glyph from rows to pages x columns bytes"""
+    pages = (height + 7) // 8
+    out = []
+    for page in range(pages):
+        for col in range(width):
+            byte = 0
+            for bit in range(8):
+                y = page * 8 + bit
+                if y < height and (rows[y] << col) & 0x8000:
+                    byte |= 1 << bit
+            out.append(byte)
+    return out
+
+
+def emit(fonts):
+    lines = [
+        "/*",
+        " * Fonts in the SSD1306 page layout, see tools/font_pages.py.",
+        " * Generated from ssd1306_fonts.c, do not edit. Included by ssd1306_fonts.c only.",
+        " *",
+        " * Each glyph is ceil(height / 8) pages of `width` bytes, one byte per",
+        " * column of 8 pixels, LSB on top. Pages are stored top to bottom.",
+        " */",
+        "",
+        "#ifndef __SSD1306_FONTS_PAGES_H__",
+        "#define __SSD1306_FONTS_PAGES_H__",
+        "",
+    ]
+    for guard, name, width, height, rows in fonts:
+        count = len(rows) // height
+        lines.append(f"#ifdef {guard}")
+        lines.append(f"static const uint8_t {name}_pages [] = {{")
+        for g in range(count):
+            data = glyph_to_pages(rows[g * height:(g + 1) * height], width, height)
+            ch = chr(FIRST_CHAR + g)
+            # A trailing backslash would continue the // comment onto the next line
+            label = {" ": "sp", "\\": "backslash"}.get(ch, ch)
+            lines.append(", ".join(f"0x{b:02X}" for b in data) + f",  // {label}")
+        lines.append("};")
+        lines.append("#endif")
+        lines.append("")
+    lines.append("#endif // __SSD1306_FONTS_PAGES_H__")
+    return "\n".join(lines) + "\n"
+
+
+def main():
+    src = sys.argv[1] if len(sys.argv) > 1 else DEFAULT_SRC
+    dst = sys.argv[2] if len(sys.argv) > 2 else DEFAULT_DST
+    with open(src) as f:
+        fonts = parse_fonts(f.read())
+    if not fonts:
+        sys.exit(f"No font tables found in {src}")
+    with open(dst, "w", newline="\n") as f:
+        f.write(emit(fonts))
+    for guard, name, width, height, rows in fonts:
+        print(f"{name}: {len(rows) // height} glyphs, {width}x{height}")
+
+
+if __name__ == "__main__":
+    main()
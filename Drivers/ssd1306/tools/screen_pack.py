@@ -0,0 +1,139 @@
+#!/usr/bin/env python3
+"""
+Static screen packer for the SSD1306 driver.
+
+Renders the screens described in screens.txt with the fonts of
+ssd1306_fonts.c and stores each one as a complete frame in the
+controller's page layout (SSD1306_BUFFER_SIZE bytes, one byte per column
+of 8 pixels, LSB on top). ssd1306_LoadScreen() copies such a frame into
+the screenbuffer, the dynamic fields are then drawn on top of it.
+
+Usage:
+    python screen_pack.py [screens.txt] [ssd1306_fonts.c] [output.c] [output.h]
+"""
+
+import os
+import sys
+
+from font_pages import FIRST_CHAR, parse_fonts
+from font_pack import label, parse_char_widths
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+ROOT = os.path.join(HERE, "..", "..", "..")
+DEFAULT_LAYOUT = os.path.join(HERE, "screens.txt")
+DEFAULT_SRC = os.path.join(HERE, "..", "ssd1306_fonts.c")
+DEFAULT_C = os.path.join(ROOT, "Core", "Src", "room_screens.c")
+DEFAULT_H = os.path.join(ROOT, "Core", "Inc", "room_screens.h")
+
+WIDTH = 128
+HEIGHT = 64
+PREFIX = "room_screen_"
+
+
+class Frame:
+    def __init__(self):
+        self.buf = [0] * (WIDTH * HEIGHT // 8)
+
+    def pixel(self, x, y, on):
+        i = x + (y // 8) * WIDTH
+        if on:
+            self.buf[i] |= 1 << (y % 8)
+        else:
+            self.buf[i] &= ~(1 << (y % 8))
+
+    def text(self, x, y, font, string):
+        """Same placement and clipping as ssd1306_WriteString(), white on black"""
+        width, height, rows, char_width = font
+        for ch in string:
+            g = ord(ch) - FIRST_CHAR
+            cw = char_width[g] if char_width else width
+            if WIDTH < x + cw or HEIGHT < y + height:
+                raise ValueError(f"'{string}' does not fit on the screen")
+            for i in range(height):
+                row = rows[g * height + i]
+                for j in range(cw):
+                    self.pixel(x + j, y + i, (row << j) & 0x8000)
+            x += cw
+
+
+def parse_layout(path, fonts):
+    screens = []
+    with open(path) as f:
+        for n, line in enumerate(f, 1):
+            line = line.rstrip("\n")
+            if not line.strip() or line.lstrip().startswith("#"):
+                continue
+            words = line.split(" ", 4)
+            try:
+                if words[0] == "screen" and len(words) == 2:
+                    screens.append((words[1], Frame()))
+                elif words[0] == "text" and len(words) == 5 and screens:
+                    screens[-1][1].text(int(words[1]), int(words[2]), fonts[words[3]], words[4])
+                else:
+                    raise ValueError("unknown statement")
+            except (KeyError, ValueError) as e:
+                sys.exit(f"{path}:{n}: {e}")
+    return screens
+
+
+def emit_c(screens, header):
+    out = [
+        "/*",
+        " * Static screens in the SSD1306 page layout, see Drivers/ssd1306/tools/screen_pack.py.",
+        " * Generated from Drivers/ssd1306/tools/screens.txt, do not edit.",
+        " */",
+        "",
+        f"#include \"{header}\"",
+        "",
+    ]
+    for name, frame in screens:
+        out.append(f"const uint8_t {PREFIX}{name}[SSD1306_BUFFER_SIZE] = {{")
+        for page in range(HEIGHT // 8):
+            row = frame.buf[page * WIDTH:(page + 1) * WIDTH]
+            for i in range(0, WIDTH, 16):
+                out.append(", ".join(f"0x{b:02X}" for b in row[i:i + 16]) + ",")
+        out.append("};")
+        out.append("")
+    return "\n".join(out)
+
+
+def emit_h(screens, header):
+    guard = header.upper().replace(".", "_")
+    out = [
+        f"#ifndef {guard}",
+        f"#define {guard}",
+        "",
+        "#include \"ssd1306.h\"",
+        "",
+        "// Generated by Drivers/ssd1306/tools/screen_pack.py, do not edit.",
+        "// Complete frames for ssd1306_LoadScreen().",
+    ]
+    out += [f"extern const uint8_t {PREFIX}{name}[SSD1306_BUFFER_SIZE];" for name, _ in screens]
+    out += ["", "#endif", ""]
+    return "\n".join(out)
+
+
+def main():
+    layout = sys.argv[1] if len(sys.argv) > 1 else DEFAULT_LAYOUT
+    src = sys.argv[2] if len(sys.argv) > 2 else DEFAULT_SRC
+    out_c = sys.argv[3] if len(sys.argv) > 3 else DEFAULT_C
+    out_h = sys.argv[4] if len(sys.argv) > 4 else DEFAULT_H
+
+    with open(src) as f:
+        source = f.read()
+    widths = parse_char_widths(source)
+    fonts = {f"{w}x{h}": (w, h, rows, widths.get(guard))
+             for guard, name, w, h, rows in parse_fonts(source)}
+    screens = parse_layout(layout, fonts)
+
+    header = os.path.basename(out_h)
+    with open(out_c, "w", newline="\n") as f:
+        f.write(emit_c(screens, header))
+    with open(out_h, "w", newline="\n") as f:
+        f.write(emit_h(screens, header))
+    for name, _ in screens:
+        print(f"{PREFIX}{name}: {WIDTH * HEIGHT // 8} bytes")
+
+
+if __name__ == "__main__":
+    main()
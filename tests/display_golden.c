@@ -0,0 +1,182 @@
+/**
+ * Golden-image regression test of the room control screens.
+ *
+ * Runs room_control on the emulated SSD1306 with a manual clock, drives it
+ * through every room_state_t and compares, for each state, the panel picture
+ * (ssd1306_HostWritePBM()) and the bytes the refresh put on the bus
+ * (ssd1306_HostGetBus()) against the files in the golden directory.
+ *
+ *   display_golden <golden_dir> <out_dir>      compare, pictures written to out_dir
+ *   display_golden -u <golden_dir>             rewrite the golden files
+ */
+
+#include "ssd1306.h"
+#include "room_control.h"
+#include "display_scheduler.h"
+#include "hal_stub.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Not in room_control.h, the only way into ROOM_STATE_EMERGENCY
+void room_control_set_state(room_control_t *room, room_state_t new_state);
+
+#define BUS_FILE    "room_bus.txt"
+
+static room_control_t room;
+static uint32_t now_ms = 1000;
+
+static const char* golden_dir;
+static const char* out_dir;
+static int update = 0;
+static int failures = 0;
+
+// Bus counters of every state, in the order they are checked
+static char bus_report[1024];
+static size_t bus_report_len = 0;
+
+static void advance(uint32_t ms) {
+    now_ms += ms;
+    ssd1306_HostSetTick(now_ms);
+}
+
+// One pass of the main loop as far as the display is concerned
+static void run_display(void) {
+    room_control_update(&room);
+    advance(100);   // Past the frame period and the key latency
+    display_scheduler_run();
+}
+
+static void press(const char* keys) {
+    for (const char* k = keys; *k; k++) {
+        room_control_process_key(&room, *k);
+        run_display();
+    }
+}
+
+static int files_equal(const char* a, const char* b) {
+    FILE* fa = fopen(a, "rb");
+    FILE* fb = fopen(b, "rb");
+    int equal = (fa != NULL && fb != NULL);
+    while (equal) {
+        int ca = fgetc(fa);
+        int cb = fgetc(fb);
+        if (ca != cb) {
+            equal = 0;
+        }
+        if (ca == EOF || cb == EOF) {
+            break;
+        }
+    }
+    if (fa) fclose(fa);
+    if (fb) fclose(fb);
+    return equal;
+}
+
+/* Captures the panel and the bus traffic since the last ssd1306_HostResetBus() */
+static void check(const char* name, room_state_t expected) {
+    char path[512];
+    char golden[512];
+    SSD1306_HostBus_t bus;
+
+    if (room_control_get_state(&room) != expected) {
+        printf("FAIL %s: state %d, expected %d\n", name, room_control_get_state(&room), expected);
+        failures++;
+    }
+
+    snprintf(golden, sizeof(golden), "%s/room_%s.pbm", golden_dir, name);
+    snprintf(path, sizeof(path), "%s/room_%s.pbm", update ? golden_dir : out_dir, name);
+    if (ssd1306_HostWritePBM(path) != 0) {
+        printf("FAIL %s: cannot write %s\n", name, path);
+        failures++;
+    } else if (!update && !files_equal(path, golden)) {
+        printf("FAIL %s: %s differs from %s\n", name, path, golden);
+        failures++;
+    }
+
+    ssd1306_HostGetBus(&bus);
+    ssd1306_HostResetBus();
+    bus_report_len += snprintf(&bus_report[bus_report_len], sizeof(bus_report) - bus_report_len,
+                               "%s %lu %lu %lu\n", name, (unsigned long)bus.CommandBytes,
+                               (unsigned long)bus.DataBytes, (unsigned long)bus.Transactions);
+}
+
+static void check_bus(void) {
+    char path[512];
+    snprintf(path, sizeof(path), "%s/" BUS_FILE, golden_dir);
+
+    if (update) {
+        FILE* f = fopen(path, "w");
+        if (f == NULL || fputs(bus_report, f) < 0) {
+            printf("FAIL cannot write %s\n", path);
+            failures++;
+        }
+        if (f) fclose(f);
+        return;
+    }
+
+    char expected[sizeof(bus_report)] = {0};
+    FILE* f = fopen(path, "r");
+    size_t len = f ? fread(expected, 1, sizeof(expected) - 1, f) : 0;
+    if (f) fclose(f);
+    if (len != bus_report_len || memcmp(expected, bus_report, len) != 0) {
+        printf("FAIL bus bytes (state command data transactions), expected:\n%sgot:\n%s", expected, bus_report);
+        failures++;
+    }
+}
+
+int main(int argc, char** argv) {
+    if (argc == 3 && strcmp(argv[1], "-u") == 0) {
+        update = 1;
+        golden_dir = argv[2];
+    } else if (argc == 3) {
+        golden_dir = argv[1];
+        out_dir = argv[2];
+    } else {
+        fprintf(stderr, "usage: %s <golden_dir> <out_dir> | -u <golden_dir>\n", argv[0]);
+        return 2;
+    }
+
+    ssd1306_HostSetTick(now_ms);
+    ssd1306_Init();
+    room_control_init(&room);
+    display_scheduler_init(DISPLAY_MAX_FPS, DISPLAY_KEY_LATENCY_MS);
+    room_control_set_temperature(&room, 22.0f);
+    ssd1306_HostResetBus();
+
+    run_display();
+    check("locked", ROOM_STATE_LOCKED);
+
+    press("12");
+    check("input_password", ROOM_STATE_INPUT_PASSWORD);
+
+    uart_stub_clear();
+    press("#");
+    check("access_denied", ROOM_STATE_ACCESS_DENIED);
+    if (strstr(uart_stub_log(), "POST /alert") == NULL) {
+        printf("FAIL access_denied: no alert sent to the ESP-01\n");
+        failures++;
+    }
+
+    advance(3000);  // ACCESS_DENIED_TIMEOUT_MS
+    run_display();
+    check("locked_after_denied", ROOM_STATE_LOCKED);
+
+    room_control_set_temperature(&room, 29.0f);
+    press("A123#");
+    run_display();
+    check("unlocked", ROOM_STATE_UNLOCKED);
+
+    room_control_set_state(&room, ROOM_STATE_EMERGENCY);
+    run_display();
+    check("emergency", ROOM_STATE_EMERGENCY);
+
+    check_bus();
+
+    if (failures) {
+        printf("display_golden: %d failure(s)\n", failures);
+        return 1;
+    }
+    printf("display_golden: %s\n", update ? "golden files written" : "OK");
+    return 0;
+}
@@ -0,0 +1,134 @@
+/**
+ * Host benchmark of ring_buffer_t: bulk copies against the byte-at-a-time API.
+ *
+ * Moves the same amount of data through a buffer the size of a uart_tx queue,
+ * in messages of several lengths, with ring_buffer_write()/ring_buffer_read(),
+ * with ring_buffer_write_n()/ring_buffer_read_n() and with the spans, and
+ * prints the time per byte and the bytes per cycle. Cycles come from the time
+ * stamp counter where there is one, so they are only comparable on one machine;
+ * the ratio between the APIs is the number to look at.
+ *
+ *   make -C tests bench
+ */
+
+#include "ring_buffer.h"
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define HAVE_CYCLES 1
+#else
+#define HAVE_CYCLES 0
+#endif
+
+#define CAPACITY        512
+#define TOTAL_BYTES     (16u * 1024u * 1024u)
+#define REPEATS         3
+
+typedef void (*method_t)(ring_buffer_t *rb, const uint8_t *msg, uint8_t *out, uint16_t len);
+
+static uint8_t storage[CAPACITY];
+static volatile uint32_t sink;
+
+static void bytewise(ring_buffer_t *rb, const uint8_t *msg, uint8_t *out, uint16_t len) {
+    for (uint16_t i = 0; i < len; i++) {
+        ring_buffer_write(rb, msg[i]);
+    }
+    for (uint16_t i = 0; i < len; i++) {
+        ring_buffer_read(rb, &out[i]);
+    }
+}
+
+static void bulk(ring_buffer_t *rb, const uint8_t *msg, uint8_t *out, uint16_t len) {
+    ring_buffer_write_n(rb, msg, len);
+    ring_buffer_read_n(rb, out, len);
+}
+
+// What uart_tx does: copy in with write_n, hand the read spans to the consumer
+static void spans(ring_buffer_t *rb, const uint8_t *msg, uint8_t *out, uint16_t len) {
+    uint8_t *span;
+    uint16_t n;
+    ring_buffer_write_n(rb, msg, len);
+    while ((n = ring_buffer_get_read_span(rb, &span)) > 0) {
+        memcpy(out, span, n);
+        out += n;
+        ring_buffer_commit_read(rb, n);
+    }
+}
+
+static double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static uint64_t cycles(void) {
+#if HAVE_CYCLES
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+// Best of REPEATS runs, per byte
+static void measure(method_t method, uint16_t len, double *ns_per_byte, double *bytes_per_cycle) {
+    static uint8_t msg[CAPACITY], out[CAPACITY];
+    ring_buffer_t rb;
+    uint32_t messages = TOTAL_BYTES / len;
+
+    for (uint16_t i = 0; i < len; i++) {
+        msg[i] = (uint8_t)(i * 7 + 1);
+    }
+    *ns_per_byte = 1e30;
+    *bytes_per_cycle = 0;
+    for (int r = 0; r < REPEATS; r++) {
+        ring_buffer_init(&rb, storage, CAPACITY);
+        // Start off the storage boundary so the messages wrap around it
+        ring_buffer_skip(&rb, (uint16_t)ring_buffer_write_n(&rb, msg, CAPACITY / 3 + 1));
+
+        double t0 = now_ns();
+        uint64_t c0 = cycles();
+        for (uint32_t m = 0; m < messages; m++) {
+            method(&rb, msg, out, len);
+            sink += out[m % len];
+        }
+        uint64_t c1 = cycles();
+        double t1 = now_ns();
+
+        double bytes = (double)messages * len;
+        if ((t1 - t0) / bytes < *ns_per_byte) {
+            *ns_per_byte = (t1 - t0) / bytes;
+        }
+        if (HAVE_CYCLES && bytes / (double)(c1 - c0) > *bytes_per_cycle) {
+            *bytes_per_cycle = bytes / (double)(c1 - c0);
+        }
+    }
+}
+
+int main(void) {
+    static const uint16_t lengths[] = { 1, 4, 16, 64, 256 };
+    static const struct {
+        const char *name;
+        method_t method;
+    } methods[] = {
+        { "write/read", bytewise },
+        { "write_n/read_n", bulk },
+        { "write_n/read spans", spans },
+    };
+
+    printf("%u bytes per run, capacity %u, best of %u\n", TOTAL_BYTES, CAPACITY, REPEATS);
+    printf("%-20s %6s %10s %12s %10s\n", "api", "len", "ns/byte", "bytes/cycle", "speedup");
+    for (size_t l = 0; l < sizeof(lengths) / sizeof(lengths[0]); l++) {
+        double base = 0;
+        for (size_t m = 0; m < sizeof(methods) / sizeof(methods[0]); m++) {
+            double ns, bpc;
+            measure(methods[m].method, lengths[l], &ns, &bpc);
+            if (m == 0) {
+                base = ns;
+            }
+            printf("%-20s %6u %10.3f %12.3f %9.1fx\n", methods[m].name, lengths[l], ns, bpc, base / ns);
+        }
+    }
+    return 0;
+}
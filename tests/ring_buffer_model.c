@@ -0,0 +1,175 @@
+/**
+ * Randomized test of ring_buffer_t against a reference model.
+ *
+ * Random sequences of every operation, the byte API included, run on buffers
+ * of random capacity. The model is a plain array that keeps the pending bytes
+ * from oldest to newest; after each operation the results, the returned bytes
+ * and the count must match it. The spans are also checked for being as long as
+ * the layout allows: either all of the data (or free space) or up to the end
+ * of the storage.
+ */
+
+#include "ring_buffer.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MAX_CAPACITY    300
+#define RUNS            2000
+#define OPS_PER_RUN     2000
+
+typedef struct {
+    uint8_t data[MAX_CAPACITY];
+    uint16_t count;
+    uint16_t capacity;
+} model_t;
+
+static uint8_t storage[MAX_CAPACITY];
+static ring_buffer_t rb;
+static model_t model;
+static unsigned seed;
+static int op_index;
+
+#define CHECK(cond, ...) do { \
+    if (!(cond)) { \
+        printf("FAIL seed %u op %d, capacity %u: ", seed, op_index, model.capacity); \
+        printf(__VA_ARGS__); \
+        printf("\n"); \
+        return 1; \
+    } \
+} while (0)
+
+static uint16_t random_len(void) {
+    // Mostly short, sometimes more than the whole buffer
+    return (rand() % 4 == 0) ? rand() % (2 * model.capacity + 2) : rand() % 8;
+}
+
+static void fill_random(uint8_t *data, uint16_t len) {
+    for (uint16_t i = 0; i < len; i++) {
+        data[i] = (uint8_t)rand();
+    }
+}
+
+static void model_append(const uint8_t *data, uint16_t len) {
+    memcpy(&model.data[model.count], data, len);
+    model.count += len;
+}
+
+static void model_consume(uint16_t len) {
+    memmove(model.data, &model.data[len], model.count - len);
+    model.count -= len;
+}
+
+static int check_state(void) {
+    CHECK(ring_buffer_count(&rb) == model.count, "count %u, model %u", ring_buffer_count(&rb), model.count);
+    CHECK(ring_buffer_is_empty(&rb) == (model.count == 0), "is_empty");
+    CHECK(ring_buffer_is_full(&rb) == (model.count == model.capacity), "is_full");
+    return 0;
+}
+
+static int step(void) {
+    uint8_t data[2 * MAX_CAPACITY + 2];
+    uint8_t *span;
+    uint16_t len, n, room = model.capacity - model.count;
+
+    switch (rand() % 11) {
+    case 0: {   // Byte write, overwrites the oldest byte when full
+        uint8_t byte = (uint8_t)rand();
+        CHECK(ring_buffer_write(&rb, byte), "write");
+        if (model.count == model.capacity) {
+            model_consume(1);
+        }
+        model_append(&byte, 1);
+        break;
+    }
+    case 1: {
+        uint8_t byte;
+        bool ok = ring_buffer_read(&rb, &byte);
+        CHECK(ok == (model.count > 0), "read returned %d with %u bytes", ok, model.count);
+        if (ok) {
+            CHECK(byte == model.data[0], "read 0x%02X, model 0x%02X", byte, model.data[0]);
+            model_consume(1);
+        }
+        break;
+    }
+    case 2:
+    case 3:
+        len = random_len();
+        fill_random(data, len);
+        n = ring_buffer_write_n(&rb, data, len);
+        CHECK(n == (len < room ? len : room), "write_n(%u) wrote %u with %u free", len, n, room);
+        model_append(data, n);
+        break;
+    case 4:
+    case 5:
+        len = random_len();
+        n = ring_buffer_read_n(&rb, data, len);
+        CHECK(n == (len < model.count ? len : model.count), "read_n(%u) read %u of %u", len, n, model.count);
+        CHECK(memcmp(data, model.data, n) == 0, "read_n bytes differ");
+        model_consume(n);
+        break;
+    case 6:
+        len = random_len();
+        n = ring_buffer_peek(&rb, data, len);
+        CHECK(n == (len < model.count ? len : model.count), "peek(%u) copied %u of %u", len, n, model.count);
+        CHECK(memcmp(data, model.data, n) == 0, "peek bytes differ");
+        break;
+    case 7:
+        len = random_len();
+        n = ring_buffer_skip(&rb, len);
+        CHECK(n == (len < model.count ? len : model.count), "skip(%u) skipped %u of %u", len, n, model.count);
+        model_consume(n);
+        break;
+    case 8:
+        n = ring_buffer_get_read_span(&rb, &span);
+        CHECK(n <= model.count, "read span %u with %u bytes", n, model.count);
+        CHECK((n == 0) == (model.count == 0), "read span %u with %u bytes", n, model.count);
+        CHECK(n == model.count || span + n == storage + model.capacity, "read span %u stops short", n);
+        CHECK(memcmp(span, model.data, n) == 0, "read span bytes differ");
+        len = n ? rand() % (n + 1) : 0;
+        ring_buffer_commit_read(&rb, len);
+        model_consume(len);
+        break;
+    case 9:
+        n = ring_buffer_get_write_span(&rb, &span);
+        CHECK(n <= room, "write span %u with %u free", n, room);
+        CHECK((n == 0) == (room == 0), "write span %u with %u free", n, room);
+        CHECK(n == room || span + n == storage + model.capacity, "write span %u stops short", n);
+        len = n ? rand() % (n + 1) : 0;
+        fill_random(span, len);
+        ring_buffer_commit_write(&rb, len);
+        model_append(span, len);
+        break;
+    default:
+        if (rand() % 8 == 0) {
+            ring_buffer_flush(&rb);
+            model.count = 0;
+        }
+        break;
+    }
+    return check_state();
+}
+
+int main(void) {
+    int failures = 0;
+
+    for (seed = 1; seed <= RUNS; seed++) {
+        srand(seed);
+        model.count = 0;
+        model.capacity = (seed % 8 == 0) ? MAX_CAPACITY : 1 + rand() % 40;
+        ring_buffer_init(&rb, storage, model.capacity);
+        for (op_index = 0; op_index < OPS_PER_RUN; op_index++) {
+            if (step()) {
+                failures++;
+                break;
+            }
+        }
+    }
+
+    if (failures) {
+        printf("ring_buffer_model: %d failing run(s)\n", failures);
+        return 1;
+    }
+    printf("ring_buffer_model: OK, %d runs of %d operations\n", RUNS, OPS_PER_RUN);
+    return 0;
+}
@@ -0,0 +1,131 @@
+/**
+ * Producer/consumer stress test of ring_buffer_spsc_*.
+ *
+ * One thread writes a pseudo-random byte stream, another reads it back and
+ * regenerates the same stream to compare: a lost, duplicated or reordered byte
+ * breaks the match at that position. Both sides yield at random points so the
+ * threads interleave at every stage of a write or read, also on a single core.
+ * Run under -fsanitize=thread with 'make -C tests tsan'.
+ */
+
+#include "ring_buffer.h"
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define BYTES_PER_RUN   2000000u
+
+typedef struct {
+    ring_buffer_spsc_t rb;
+    uint32_t capacity;
+    uint32_t write_fails;       // Buffer full
+    uint32_t read_fails;        // Buffer empty
+    uint32_t over_capacity;     // Counts above the capacity seen by the consumer
+    uint32_t mismatch_at;       // Position of the first wrong byte, or BYTES_PER_RUN
+    uint8_t got, expected;
+} stress_t;
+
+// xorshift32: the stream and the yield points, seeded differently on each side
+static uint32_t next(uint32_t *state) {
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return *state = x;
+}
+
+static void *producer(void *arg) {
+    stress_t *s = arg;
+    uint32_t stream = 0x12345678u;
+    uint32_t jitter = 0x9E3779B9u;
+
+    for (uint32_t i = 0; i < BYTES_PER_RUN; i++) {
+        uint8_t byte = (uint8_t)(next(&stream) >> 24);
+        while (!ring_buffer_spsc_write(&s->rb, byte)) {
+            s->write_fails++;
+            sched_yield();
+        }
+        if ((next(&jitter) & 0x3F) == 0) {
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+static void *consumer(void *arg) {
+    stress_t *s = arg;
+    uint32_t stream = 0x12345678u;
+    uint32_t jitter = 0x7F4A7C15u;
+
+    s->mismatch_at = BYTES_PER_RUN;
+    for (uint32_t i = 0; i < BYTES_PER_RUN; i++) {
+        uint8_t expected = (uint8_t)(next(&stream) >> 24);
+        uint8_t byte;
+        while (!ring_buffer_spsc_read(&s->rb, &byte)) {
+            s->read_fails++;
+            sched_yield();
+        }
+        if (byte != expected && s->mismatch_at == BYTES_PER_RUN) {
+            s->mismatch_at = i;
+            s->got = byte;
+            s->expected = expected;
+        }
+        if (ring_buffer_spsc_count(&s->rb) > s->capacity) {
+            s->over_capacity++;
+        }
+        if ((next(&jitter) & 0x3F) == 0) {
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+static int run(uint32_t capacity) {
+    static uint8_t storage[4096];
+    stress_t s = { .capacity = capacity };
+    pthread_t threads[2];
+    int failures = 0;
+
+    if (!ring_buffer_spsc_init(&s.rb, storage, capacity)) {
+        printf("FAIL capacity %u rejected\n", (unsigned)capacity);
+        return 1;
+    }
+    pthread_create(&threads[0], NULL, producer, &s);
+    pthread_create(&threads[1], NULL, consumer, &s);
+    pthread_join(threads[0], NULL);
+    pthread_join(threads[1], NULL);
+
+    if (s.mismatch_at != BYTES_PER_RUN) {
+        printf("FAIL capacity %u: byte %u is 0x%02X, expected 0x%02X (lost or reordered)\n",
+               (unsigned)capacity, (unsigned)s.mismatch_at, s.got, s.expected);
+        failures++;
+    }
+    if (!ring_buffer_spsc_is_empty(&s.rb)) {
+        printf("FAIL capacity %u: %u bytes left over\n", (unsigned)capacity, (unsigned)ring_buffer_spsc_count(&s.rb));
+        failures++;
+    }
+    if (s.over_capacity) {
+        printf("FAIL capacity %u: count above capacity %u times\n", (unsigned)capacity, (unsigned)s.over_capacity);
+        failures++;
+    }
+    printf("capacity %4u: %u bytes, %u full waits, %u empty waits\n", (unsigned)capacity,
+           BYTES_PER_RUN, (unsigned)s.write_fails, (unsigned)s.read_fails);
+    return failures;
+}
+
+int main(void) {
+    static const uint32_t capacities[] = { 1, 2, 16, 256, 4096 };
+    int failures = 0;
+
+    for (size_t i = 0; i < sizeof(capacities) / sizeof(capacities[0]); i++) {
+        failures += run(capacities[i]);
+    }
+
+    if (failures) {
+        printf("ring_buffer_spsc_stress: %d failure(s)\n", failures);
+        return 1;
+    }
+    printf("ring_buffer_spsc_stress: OK\n");
+    return 0;
+}
@@ -0,0 +1,109 @@
+/**
+ * Asynchronous flush of the SSD1306 driver against the blocking one.
+ *
+ * The same random drawing sequence is flushed three times: through the
+ * blocking host transport, which gives the reference picture of every frame,
+ * through SSD1306_TransportHostAsync with the transfers completed one by one
+ * from the test, and through SSD1306_TransportHostInline, whose completion
+ * runs before WriteAsync returns. Every frame must reach the panel unchanged.
+ * A last async run fails a transfer of every few frames half way: the frame
+ * after it must still reach the panel whole.
+ */
+
+#include "ssd1306.h"
+#include "ssd1306_host.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define FRAMES      300
+#define SEED        12345u
+#define FAIL_EVERY  7
+
+typedef uint8_t picture_t[SSD1306_HEIGHT][SSD1306_WIDTH];
+
+static picture_t reference[FRAMES];
+
+static void snapshot(picture_t picture) {
+    for (uint8_t y = 0; y < SSD1306_HEIGHT; y++) {
+        for (uint8_t x = 0; x < SSD1306_WIDTH; x++) {
+            picture[y][x] = ssd1306_HostPixel(x, y);
+        }
+    }
+}
+
+// A few rectangles and pixels, sometimes a whole-screen change
+static void draw_frame(void) {
+    int shapes = 1 + rand() % 4;
+    if (rand() % 16 == 0) {
+        ssd1306_Fill((rand() & 1) ? White : Black);
+    }
+    for (int i = 0; i < shapes; i++) {
+        uint8_t x1 = rand() % SSD1306_WIDTH;
+        uint8_t y1 = rand() % SSD1306_HEIGHT;
+        uint8_t x2 = x1 + rand() % (SSD1306_WIDTH - x1);
+        uint8_t y2 = y1 + rand() % (SSD1306_HEIGHT - y1);
+        ssd1306_FillRectangle(x1, y1, x2, y2, (rand() & 1) ? White : Black);
+    }
+    for (int i = rand() % 8; i > 0; i--) {
+        ssd1306_DrawPixel(rand() % SSD1306_WIDTH, rand() % SSD1306_HEIGHT, (rand() & 1) ? White : Black);
+    }
+}
+
+static int run(const char* name, const SSD1306_Transport_t* transport, int record, int fail_every) {
+    picture_t picture;
+    int failures = 0;
+
+    ssd1306_InitTransport(transport);
+    srand(SEED);
+    for (int frame = 0; frame < FRAMES; frame++) {
+        draw_frame();
+        if (record) {
+            ssd1306_UpdateScreen();
+            snapshot(reference[frame]);
+            continue;
+        }
+
+        if (ssd1306_UpdateScreenAsync() != SSD1306_OK) {
+            printf("FAIL %s: frame %d not started\n", name, frame);
+            return 1;
+        }
+        int fail = fail_every && frame % fail_every == 0;
+        for (int transfer = 0; ssd1306_HostCompleteTransfer(); transfer++) {
+            if (fail && transfer == 1) {
+                ssd1306_HostFailTransfer();
+            }
+        }
+        if (ssd1306_IsFlushBusy()) {
+            printf("FAIL %s: frame %d still flushing with nothing pending\n", name, frame);
+            return 1;
+        }
+        if (fail) {
+            // The panel is stale until the next flush
+            continue;
+        }
+        snapshot(picture);
+        if (memcmp(picture, reference[frame], sizeof(picture)) != 0) {
+            printf("FAIL %s: frame %d differs from the blocking flush\n", name, frame);
+            failures++;
+        }
+    }
+    return failures;
+}
+
+int main(void) {
+    int failures = 0;
+
+    ssd1306_HostSetTick(0);
+    run("blocking", &SSD1306_TransportHost, 1, 0);
+    failures += run("async", &SSD1306_TransportHostAsync, 0, 0);
+    failures += run("inline", &SSD1306_TransportHostInline, 0, 0);
+    failures += run("async with errors", &SSD1306_TransportHostAsync, 0, FAIL_EVERY);
+
+    if (failures) {
+        printf("ssd1306_async: %d failure(s)\n", failures);
+        return 1;
+    }
+    printf("ssd1306_async: OK, %d frames per transport\n", FRAMES);
+    return 0;
+}
@@ -0,0 +1,55 @@
+#include "hal_stub.h"
+#include "uart_tx.h"
+#include <string.h>
+
+GPIO_TypeDef host_gpio[3];
+TIM_HandleTypeDef htim3;
+UART_HandleTypeDef huart2 = { 2 };
+UART_HandleTypeDef huart3 = { 3 };
+
+static char uart_log[UART_STUB_LOG_SIZE];
+static size_t uart_log_len = 0;
+
+void HAL_GPIO_WritePin(GPIO_TypeDef* port, uint16_t pin, GPIO_PinState state) {
+    if (state == GPIO_PIN_SET) {
+        port->ODR |= pin;
+    } else {
+        port->ODR &= ~(uint32_t)pin;
+    }
+}
+
+void HAL_GPIO_TogglePin(GPIO_TypeDef* port, uint16_t pin) {
+    port->ODR ^= pin;
+}
+
+HAL_StatusTypeDef HAL_TIM_PWM_Start(TIM_HandleTypeDef* htim, uint32_t channel) {
+    (void)channel;
+    htim->Running = 1;
+    return HAL_OK;
+}
+
+void Error_Handler(void) {
+}
+
+// Everything sent to USART3 (the ESP-01) lands in uart_log
+bool uart_send(UART_HandleTypeDef *huart, const void *data, uint16_t len) {
+    if (huart != &huart3) {
+        return true;
+    }
+    if (uart_log_len + len >= sizeof(uart_log)) {
+        return false;
+    }
+    memcpy(&uart_log[uart_log_len], data, len);
+    uart_log_len += len;
+    uart_log[uart_log_len] = '\0';
+    return true;
+}
+
+const char* uart_stub_log(void) {
+    return uart_log;
+}
+
+void uart_stub_clear(void) {
+    uart_log_len = 0;
+    uart_log[0] = '\0';
+}
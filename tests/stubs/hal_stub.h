@@ -0,0 +1,17 @@
+#ifndef HOST_HAL_STUB_H
+#define HOST_HAL_STUB_H
+
+#include <stdbool.h>
+#include "stm32l4xx_hal.h"
+
+#define UART_STUB_LOG_SIZE  1024
+
+extern TIM_HandleTypeDef htim3;
+extern UART_HandleTypeDef huart2;
+extern UART_HandleTypeDef huart3;
+
+// What room_control sent to the ESP-01 since the last uart_stub_clear()
+const char* uart_stub_log(void);
+void uart_stub_clear(void);
+
+#endif // HOST_HAL_STUB_H
@@ -0,0 +1,83 @@
+/**
+ * Host stand-in for the STM32L4 HAL, just what the application modules under
+ * test touch. GPIO writes and the fan PWM compare are recorded so a test can
+ * check them; the clock comes from ssd1306_host.c (see ssd1306_HostSetTick()).
+ */
+
+#ifndef HOST_STM32L4XX_HAL_H
+#define HOST_STM32L4XX_HAL_H
+
+#include <stdint.h>
+
+#ifndef HAL_MAX_DELAY
+#define HAL_MAX_DELAY      0xFFFFFFFFU
+#endif
+
+typedef enum {
+    HAL_OK = 0,
+    HAL_ERROR,
+    HAL_BUSY,
+    HAL_TIMEOUT
+} HAL_StatusTypeDef;
+
+uint32_t HAL_GetTick(void);
+void HAL_Delay(uint32_t delay);
+
+// GPIO: the output register of each port
+typedef struct {
+    uint32_t ODR;
+} GPIO_TypeDef;
+
+extern GPIO_TypeDef host_gpio[3];
+#define GPIOA   (&host_gpio[0])
+#define GPIOB   (&host_gpio[1])
+#define GPIOC   (&host_gpio[2])
+
+#define GPIO_PIN_0      ((uint16_t)0x0001)
+#define GPIO_PIN_1      ((uint16_t)0x0002)
+#define GPIO_PIN_2      ((uint16_t)0x0004)
+#define GPIO_PIN_3      ((uint16_t)0x0008)
+#define GPIO_PIN_4      ((uint16_t)0x0010)
+#define GPIO_PIN_5      ((uint16_t)0x0020)
+#define GPIO_PIN_6      ((uint16_t)0x0040)
+#define GPIO_PIN_7      ((uint16_t)0x0080)
+#define GPIO_PIN_8      ((uint16_t)0x0100)
+#define GPIO_PIN_9      ((uint16_t)0x0200)
+#define GPIO_PIN_10     ((uint16_t)0x0400)
+#define GPIO_PIN_11     ((uint16_t)0x0800)
+#define GPIO_PIN_12     ((uint16_t)0x1000)
+#define GPIO_PIN_13     ((uint16_t)0x2000)
+#define GPIO_PIN_14     ((uint16_t)0x4000)
+#define GPIO_PIN_15     ((uint16_t)0x8000)
+
+typedef enum {
+    GPIO_PIN_RESET = 0,
+    GPIO_PIN_SET
+} GPIO_PinState;
+
+void HAL_GPIO_WritePin(GPIO_TypeDef* port, uint16_t pin, GPIO_PinState state);
+void HAL_GPIO_TogglePin(GPIO_TypeDef* port, uint16_t pin);
+
+// TIM: only the channel 1 compare value of the fan PWM
+typedef struct {
+    uint32_t Compare;
+    uint8_t Running;
+} TIM_HandleTypeDef;
+
+#define TIM_CHANNEL_1   0x00000000U
+#define __HAL_TIM_SET_COMPARE(htim, channel, value) ((htim)->Compare = (value))
+
+HAL_StatusTypeDef HAL_TIM_PWM_Start(TIM_HandleTypeDef* htim, uint32_t channel);
+
+// UART: handles only, output goes through the uart_send() stub
+typedef struct {
+    uint8_t Port;
+} UART_HandleTypeDef;
+
+// Interrupts do not exist on the host
+static inline uint32_t __get_PRIMASK(void) { return 0; }
+static inline void __set_PRIMASK(uint32_t primask) { (void)primask; }
+static inline void __disable_irq(void) {}
+static inline uint32_t __get_IPSR(void) { return 0; }
+
+#endif // HOST_STM32L4XX_HAL_H